@@ -0,0 +1,244 @@
+#include "kbench.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+#define HIGH_PRIO       (KBENCH_PRIO + 1)
+#define HELPER_WORDS    (configMINIMAL_STACK_SIZE * 2)
+#define CHUNK           64
+#define MESSAGE         16
+#define BUFFER_BYTES    1024
+#define TIMER_ROUNDS    100
+
+static TaskHandle_t runner;
+static QueueHandle_t queue;
+static SemaphoreHandle_t sem;
+static StreamBufferHandle_t stream;
+static TaskHandle_t helper;
+static volatile uint32_t helper_bytes;
+static volatile uint64_t timer_fired_ns;
+static volatile int stop;
+static void (*isr_action)(void);
+
+static void report(const char *test, uint32_t n, uint64_t ns, const char *extra) {
+    printf("kbench port=%s test=%s n=%lu ns_per_op=%.1f%s\n", kbench_port, test,
+           (unsigned long)n, (double)ns / n, extra ? extra : "");
+}
+
+static void isr_dispatch(void) {
+    isr_action();
+}
+
+static void spawn(TaskFunction_t fn, UBaseType_t prio) {
+    stop = 0;
+    xTaskCreate(fn, "kb", HELPER_WORDS, NULL, prio, &helper);
+}
+
+static void reap(void) {
+    vTaskDelete(helper);
+    helper = NULL;
+    vTaskDelay(1); // let the idle task free it
+}
+
+// --- queue ---------------------------------------------------------------
+
+static void bench_queue_noblock(uint32_t n) {
+    uint32_t v = 0;
+    uint64_t t0 = kbench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        xQueueSend(queue, &v, 0);
+        xQueueReceive(queue, &v, 0);
+    }
+    report("queue_send_recv_noblock", n, kbench_now_ns() - t0, NULL);
+}
+
+static void queue_receiver(void *p) {
+    (void)p;
+    uint32_t v;
+    for (;;) xQueueReceive(queue, &v, portMAX_DELAY);
+}
+
+// Each send unblocks a higher priority receiver: send, two switches and
+// the receive.
+static void bench_queue_block(uint32_t n) {
+    uint32_t v = 0;
+    spawn(queue_receiver, HIGH_PRIO);
+    uint64_t t0 = kbench_now_ns();
+    for (uint32_t i = 0; i < n; i++) xQueueSend(queue, &v, portMAX_DELAY);
+    report("queue_send_wake_recv", n, kbench_now_ns() - t0, NULL);
+    reap();
+}
+
+// --- semaphore and notification, from a task and from an ISR ------------
+
+static void sem_taker(void *p) {
+    (void)p;
+    for (;;) xSemaphoreTake(sem, portMAX_DELAY);
+}
+
+static void notify_taker(void *p) {
+    (void)p;
+    for (;;) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+static void isr_give_sem(void) {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(sem, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static void isr_notify(void) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(helper, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static void bench_from_isr(const char *test, TaskFunction_t taker, void (*action)(void), uint32_t n) {
+    spawn(taker, HIGH_PRIO);
+    isr_action = action;
+    uint64_t t0 = kbench_now_ns();
+    for (uint32_t i = 0; i < n; i++) kbench_isr_trigger();
+    report(test, n, kbench_now_ns() - t0, NULL);
+    reap();
+}
+
+static void bench_notify_task(uint32_t n) {
+    spawn(notify_taker, HIGH_PRIO);
+    uint64_t t0 = kbench_now_ns();
+    for (uint32_t i = 0; i < n; i++) xTaskNotifyGive(helper);
+    report("notify_give_wake", n, kbench_now_ns() - t0, NULL);
+    reap();
+}
+
+static void bench_sem_task(uint32_t n) {
+    spawn(sem_taker, HIGH_PRIO);
+    uint64_t t0 = kbench_now_ns();
+    for (uint32_t i = 0; i < n; i++) xSemaphoreGive(sem);
+    report("sem_give_wake", n, kbench_now_ns() - t0, NULL);
+    reap();
+}
+
+// --- stream and message buffers -----------------------------------------
+
+static void stream_reader(void *p) {
+    (void)p;
+    uint8_t buf[CHUNK];
+    for (;;) helper_bytes += xStreamBufferReceive(stream, buf, sizeof(buf), portMAX_DELAY);
+}
+
+static void message_reader(void *p) {
+    (void)p;
+    uint8_t buf[MESSAGE];
+    for (;;) helper_bytes += xMessageBufferReceive(stream, buf, sizeof(buf), portMAX_DELAY);
+}
+
+static void bench_buffer(const char *test, bool message, uint32_t n) {
+    static uint8_t data[CHUNK];
+    size_t len = message ? MESSAGE : CHUNK;
+    stream = message ? xMessageBufferCreate(BUFFER_BYTES) : xStreamBufferCreate(BUFFER_BYTES, 1);
+    helper_bytes = 0;
+    spawn(message ? message_reader : stream_reader, HIGH_PRIO);
+    uint64_t t0 = kbench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        if (message) xMessageBufferSend(stream, data, len, portMAX_DELAY);
+        else xStreamBufferSend(stream, data, len, portMAX_DELAY);
+    }
+    uint64_t dt = kbench_now_ns() - t0;
+    char extra[48];
+    snprintf(extra, sizeof(extra), " bytes=%lu bytes_per_s=%.0f", (unsigned long)helper_bytes,
+             helper_bytes * 1e9 / (double)dt);
+    report(test, n, dt, extra);
+    reap();
+    vStreamBufferDelete(stream);
+}
+
+// --- context switch -------------------------------------------------------
+
+static void yielder(void *p) {
+    (void)p;
+    while (!stop) taskYIELD();
+    for (;;) vTaskSuspend(NULL);
+}
+
+// Two tasks of equal priority yielding to each other: one switch per
+// yield.
+static void bench_context_switch(uint32_t n) {
+    spawn(yielder, KBENCH_PRIO);
+    taskYIELD();
+    uint64_t t0 = kbench_now_ns();
+    for (uint32_t i = 0; i < n; i++) taskYIELD();
+    uint64_t dt = kbench_now_ns() - t0;
+    stop = 1;
+    report("context_switch", 2 * n, dt, NULL);
+    taskYIELD();
+    reap();
+}
+
+// --- timer service --------------------------------------------------------
+
+static void timer_cb(TimerHandle_t t) {
+    (void)t;
+    timer_fired_ns = kbench_now_ns();
+    xTaskNotifyGive(runner);
+}
+
+// One-shot timers of one tick: latency is from the expiring tick to the
+// callback running in the timer task. The runner sits above the timer
+// task while it waits, so it sees the tick count change and stamps it
+// before the callback can run; then it blocks and lets the timer task in.
+static void bench_timer(void) {
+    TimerHandle_t t = xTimerCreate("kb", 1, pdFALSE, NULL, timer_cb);
+    uint64_t total = 0, min = UINT64_MAX, max = 0;
+    vTaskPrioritySet(NULL, configTIMER_TASK_PRIORITY + 1);
+    for (uint32_t i = 0; i < TIMER_ROUNDS; i++) {
+        vTaskDelay(1);
+        TickType_t start = xTaskGetTickCount();
+        xTimerStart(t, portMAX_DELAY);
+        while (xTaskGetTickCount() == start) {
+        }
+        uint64_t t_tick = kbench_now_ns();
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint64_t l = timer_fired_ns - t_tick;
+        total += l;
+        if (l < min) min = l;
+        if (l > max) max = l;
+    }
+    vTaskPrioritySet(NULL, KBENCH_PRIO);
+    char extra[64];
+    snprintf(extra, sizeof(extra), " min_ns=%llu max_ns=%llu",
+             (unsigned long long)min, (unsigned long long)max);
+    report("timer_service_latency", TIMER_ROUNDS, total, extra);
+    xTimerDelete(t, portMAX_DELAY);
+}
+
+void kbench_run(uint32_t ops) {
+    runner = xTaskGetCurrentTaskHandle();
+    queue = xQueueCreate(1, sizeof(uint32_t));
+    sem = xSemaphoreCreateBinary();
+    kbench_isr_install(isr_dispatch);
+
+    printf("kbench port=%s begin kernel=%s tick_hz=%u ops=%lu\n", kbench_port,
+           tskKERNEL_VERSION_NUMBER, (unsigned)configTICK_RATE_HZ, (unsigned long)ops);
+    bench_queue_noblock(ops);
+    bench_queue_block(ops);
+    bench_sem_task(ops);
+    bench_from_isr("sem_give_isr_wake", sem_taker, isr_give_sem, ops);
+    bench_notify_task(ops);
+    bench_from_isr("notify_give_isr_wake", notify_taker, isr_notify, ops);
+    bench_buffer("stream_buffer", false, ops);
+    bench_buffer("message_buffer", true, ops);
+    bench_context_switch(ops);
+    bench_timer();
+    printf("kbench port=%s end\n", kbench_port);
+
+    vQueueDelete(queue);
+    vSemaphoreDelete(sem);
+}
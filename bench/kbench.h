@@ -0,0 +1,27 @@
+#ifndef KBENCH_H
+#define KBENCH_H
+
+#include <stdint.h>
+
+// Kernel primitive microbenchmarks, shared by the RP2040 target
+// (bench/rp2040.c) and the Posix port (host/kernel_bench). Each test
+// prints one line:
+//
+//   kbench port=<port> test=<name> n=<ops> ns_per_op=<mean> [more key=value]
+//
+// tools/kbench_compare.py diffs two runs on ns_per_op.
+
+// Provided by the port file.
+extern const char *const kbench_port;
+uint64_t kbench_now_ns(void);
+// Runs the handler installed by kbench_run in interrupt context and
+// returns after it (and any switch it requested) completed.
+void kbench_isr_trigger(void);
+void kbench_isr_install(void (*handler)(void));
+
+// Runs every test from a task of priority KBENCH_PRIO with ops iterations
+// each; helper tasks are created and deleted per test.
+#define KBENCH_PRIO 2
+void kbench_run(uint32_t ops);
+
+#endif // KBENCH_H
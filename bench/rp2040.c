@@ -0,0 +1,58 @@
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+
+#include "kbench.h"
+
+// kernel_bench firmware: runs the suite each time a byte arrives on the
+// USB serial port and prints the results there
+// (tools/kbench_compare.py --port sends the byte and collects them).
+// The *_isr_* rows pend a spare user IRQ, so they include exception entry
+// and exit.
+
+#define KBENCH_OPS 2000
+
+const char *const kbench_port = "rp2040";
+
+static uint user_irq;
+
+uint64_t kbench_now_ns(void) {
+    return time_us_64() * 1000u;
+}
+
+void kbench_isr_install(void (*handler)(void)) {
+    irq_set_exclusive_handler(user_irq, handler);
+    irq_set_enabled(user_irq, true);
+}
+
+void kbench_isr_trigger(void) {
+    irq_set_pending(user_irq);
+    __dsb();
+    __isb();
+}
+
+static void bench_task(void *p) {
+    (void)p;
+    for (;;) {
+        if (getchar_timeout_us(0) == PICO_ERROR_TIMEOUT) {
+            vTaskDelay(pdMS_TO_TICKS(100));
+            continue;
+        }
+        kbench_run(KBENCH_OPS);
+        irq_set_enabled(user_irq, false);
+        irq_remove_handler(user_irq, irq_get_exclusive_handler(user_irq));
+    }
+}
+
+int main() {
+    stdio_init_all();
+    user_irq = user_irq_claim_unused(true);
+    xTaskCreate(bench_task, "kbench", 1024, NULL, KBENCH_PRIO, NULL);
+    vTaskStartScheduler();
+    while (1) tight_loop_contents();
+    return 0;
+}
@@ -1,24 +1,35 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
-/* Use Pico SDK ISR handlers */
+#include "hardware/timer.h"
+
+#ifndef FREERTOS_SMP
+#define FREERTOS_SMP 0
+#endif
+
+/* Use Pico SDK ISR handlers. The SMP RP2040 port installs its own. */
+#if !FREERTOS_SMP
 #define vPortSVCHandler         isr_svcall
 #define xPortPendSVHandler      isr_pendsv
 #define xPortSysTickHandler     isr_systick
+#endif
 
 #define configUSE_PREEMPTION                    1
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
-#define configUSE_TICKLESS_IDLE                 0
+/* Tickless idle: tickless.c on the RP2040 timer for the vendored port; the
+ * SMP RP2040 port keeps its own SysTick-based implementation. */
+#define configUSE_TICKLESS_IDLE                 1
 #define configCPU_CLOCK_HZ                      133000000
 #define configTICK_RATE_HZ                      100
-#define configMAX_PRIORITIES                    5
+#define configMAX_PRIORITIES                    6
 #define configMINIMAL_STACK_SIZE                128
 #define configMAX_TASK_NAME_LEN                 16
 #define configUSE_16_BIT_TICKS                  0
 #define configIDLE_SHOULD_YIELD                 1
 #define configUSE_TASK_NOTIFICATIONS            1
 #define configTASK_NOTIFICATION_ARRAY_ENTRIES   3
-#define configUSE_MUTEXES                       0
+/* One mutex: whole frames on stdio (main/app_tasks.h, APP_MUTEXES). */
+#define configUSE_MUTEXES                       1
 #define configUSE_RECURSIVE_MUTEXES             0
 #define configUSE_COUNTING_SEMAPHORES           0
 #define configQUEUE_REGISTRY_SIZE               10
@@ -28,12 +39,38 @@
 #define configENABLE_BACKWARD_COMPATIBILITY     0
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
 #define configSTACK_DEPTH_TYPE                  uint16_t
-#define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
+/* Records in main/evpath.c are under 256 bytes: one length byte each. */
+#define configMESSAGE_BUFFER_LENGTH_TYPE        uint8_t
+
+/* SMP (FREERTOS_SMP, external V11+ kernel only). Both cores take tasks
+ * from one ready list; APP_TASKS pins tasks with its core column. */
+#if FREERTOS_SMP
+#define configNUMBER_OF_CORES                   2
+#define configTICK_CORE                         0
+#define configRUN_MULTIPLE_PRIORITIES           1
+#define configUSE_CORE_AFFINITY                 1
+#define configUSE_PASSIVE_IDLE_HOOK             0
+#define configSUPPORT_PICO_SYNC_INTEROP         1
+#define configSUPPORT_PICO_TIME_INTEROP         1
+#else
+#define configNUMBER_OF_CORES                   1
+#endif
 
-/* Memory allocation related definitions. */
+/* Memory allocation related definitions. FREERTOS_STATIC_ALLOCATION comes
+ * from CMake; in that mode the application supplies every TCB, stack and
+ * queue buffer (main/app_tasks.h) and there is no heap. */
+#ifndef FREERTOS_STATIC_ALLOCATION
+#define FREERTOS_STATIC_ALLOCATION              0
+#endif
+#if FREERTOS_STATIC_ALLOCATION
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configSUPPORT_DYNAMIC_ALLOCATION        0
+#else
 #define configSUPPORT_STATIC_ALLOCATION         0
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
-#define configAPPLICATION_ALLOCATED_HEAP        1
+#endif
+#define configTOTAL_HEAP_SIZE                   ( 96 * 1024 )
+#define configAPPLICATION_ALLOCATED_HEAP        0
 
 /* Hook function related definitions. */
 #define configUSE_IDLE_HOOK                     0
@@ -43,17 +80,21 @@
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
 #define configUSE_TRACE_FACILITY                0
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
+/* Run time counter is the 1 MHz RP2040 timer, already running at boot. */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        time_us_32()
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         1
 
 /* Software timer related definitions. */
 #define configUSE_TIMERS                        1
-#define configTIMER_TASK_PRIORITY               3
+#define configTIMER_TASK_PRIORITY               4
 #define configTIMER_QUEUE_LENGTH                10
 #define configTIMER_TASK_STACK_DEPTH            configMINIMAL_STACK_SIZE
 
@@ -71,7 +112,7 @@
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
 #define INCLUDE_uxTaskGetStackHighWaterMark     0
-#define INCLUDE_xTaskGetIdleTaskHandle          0
+#define INCLUDE_xTaskGetIdleTaskHandle          1
 #define INCLUDE_eTaskGetState                   0
 #define INCLUDE_xEventGroupSetBitFromISR        1
 #define INCLUDE_xTimerPendFunctionCall          0
@@ -81,4 +122,14 @@
 
 /* A header file that defines trace macro can be included here. */
 
+/* Loop body execution times (wcet.c): the tasks' time switched out is
+ * subtracted from their measurements. */
+#define configWCET_TLS_INDEX                    ( configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1 )
+#ifndef __ASSEMBLER__
+void vWcetSwitchedOut( void );
+void vWcetSwitchedIn( void );
+#endif
+#define traceTASK_SWITCHED_OUT()                vWcetSwitchedOut()
+#define traceTASK_SWITCHED_IN()                 vWcetSwitchedIn()
+
 #endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,464 @@
+/*
+ * Two-level segregated fit (TLSF) heap for FreeRTOS.
+ *
+ * Free blocks live in size classes indexed by a first level (power of two)
+ * and a second level (tlsfSL_COUNT linear steps inside it). Two bitmaps
+ * record which classes are non-empty, so both pvPortMalloc() and
+ * vPortFree() run in constant time: a couple of bit scans, at most one
+ * split and at most two merges with the physical neighbours. Every class
+ * searched is guaranteed to fit, so there is no list walk.
+ *
+ * Replaces heap_3.c (newlib malloc behind vTaskSuspendAll) and adds
+ * telemetry through vPortGetHeapTelemetry().
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "heap_tlsf.h"
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#define tlsfALIGN_LOG2     3
+#define tlsfALIGN          ( ( size_t ) 1 << tlsfALIGN_LOG2 )
+#define tlsfSL_LOG2        4
+#define tlsfSL_COUNT       ( 1u << tlsfSL_LOG2 )
+#define tlsfFL_SHIFT       ( tlsfSL_LOG2 + tlsfALIGN_LOG2 )
+#define tlsfSMALL_BLOCK    ( ( size_t ) 1 << tlsfFL_SHIFT )
+#define tlsfFL_MAX_LOG2    24
+#define tlsfFL_COUNT       ( tlsfFL_MAX_LOG2 - tlsfFL_SHIFT + 1 )
+
+#define tlsfFREE_BIT       ( ( size_t ) 1 )
+
+/* The free list links only exist while the block is free; they overlay the
+ * first bytes of the payload. */
+typedef struct BlockHeader
+{
+    struct BlockHeader * pxPrevPhys;
+    size_t xSize; /* Payload size, tlsfFREE_BIT set while free. */
+    struct BlockHeader * pxNextFree;
+    struct BlockHeader * pxPrevFree;
+} Block_t;
+
+#define tlsfHEADER         ( offsetof( Block_t, pxNextFree ) )
+#define tlsfMIN_PAYLOAD    ( sizeof( Block_t ) - tlsfHEADER )
+
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif
+
+PRIVILEGED_DATA static uint32_t ulFlBitmap = 0;
+PRIVILEGED_DATA static uint32_t ulSlBitmap[ tlsfFL_COUNT ];
+PRIVILEGED_DATA static Block_t * pxFreeLists[ tlsfFL_COUNT ][ tlsfSL_COUNT ];
+PRIVILEGED_DATA static BaseType_t xHeapReady = pdFALSE;
+
+PRIVILEGED_DATA static HeapTelemetry_t xTelemetry;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytes = 0;
+
+/*-----------------------------------------------------------*/
+
+static inline size_t prvSize( const Block_t * pxBlock )
+{
+    return pxBlock->xSize & ~tlsfFREE_BIT;
+}
+
+static inline BaseType_t prvIsFree( const Block_t * pxBlock )
+{
+    return ( pxBlock->xSize & tlsfFREE_BIT ) ? pdTRUE : pdFALSE;
+}
+
+static inline Block_t * prvNextPhys( const Block_t * pxBlock )
+{
+    return ( Block_t * ) ( ( uint8_t * ) pxBlock + tlsfHEADER + prvSize( pxBlock ) );
+}
+
+static inline uint32_t prvFls( size_t x )
+{
+    return ( uint32_t ) ( sizeof( unsigned long ) * 8 - 1 ) - ( uint32_t ) __builtin_clzl( ( unsigned long ) x );
+}
+
+static void prvMappingInsert( size_t xSize,
+                              uint32_t * pulFl,
+                              uint32_t * pulSl )
+{
+    if( xSize < tlsfSMALL_BLOCK )
+    {
+        *pulFl = 0;
+        *pulSl = ( uint32_t ) ( xSize / ( tlsfSMALL_BLOCK / tlsfSL_COUNT ) );
+    }
+    else
+    {
+        uint32_t ulFls = prvFls( xSize );
+        *pulSl = ( uint32_t ) ( xSize >> ( ulFls - tlsfSL_LOG2 ) ) ^ tlsfSL_COUNT;
+        *pulFl = ulFls - tlsfFL_SHIFT + 1;
+    }
+}
+
+/* Rounds the request up to the next class boundary so any block found in
+ * the chosen class is large enough. */
+static BaseType_t prvMappingSearch( size_t xSize,
+                                    uint32_t * pulFl,
+                                    uint32_t * pulSl )
+{
+    if( xSize >= tlsfSMALL_BLOCK )
+    {
+        xSize += ( ( size_t ) 1 << ( prvFls( xSize ) - tlsfSL_LOG2 ) ) - 1;
+    }
+
+    prvMappingInsert( xSize, pulFl, pulSl );
+
+    return ( *pulFl < tlsfFL_COUNT ) ? pdTRUE : pdFALSE;
+}
+
+static void prvInsertFree( Block_t * pxBlock )
+{
+    uint32_t ulFl, ulSl;
+
+    prvMappingInsert( prvSize( pxBlock ), &ulFl, &ulSl );
+
+    pxBlock->xSize |= tlsfFREE_BIT;
+    pxBlock->pxPrevFree = NULL;
+    pxBlock->pxNextFree = pxFreeLists[ ulFl ][ ulSl ];
+
+    if( pxBlock->pxNextFree != NULL )
+    {
+        pxBlock->pxNextFree->pxPrevFree = pxBlock;
+    }
+
+    pxFreeLists[ ulFl ][ ulSl ] = pxBlock;
+    ulFlBitmap |= 1u << ulFl;
+    ulSlBitmap[ ulFl ] |= 1u << ulSl;
+    xTelemetry.xFreeBlocks++;
+}
+
+static void prvRemoveFree( Block_t * pxBlock )
+{
+    uint32_t ulFl, ulSl;
+
+    prvMappingInsert( prvSize( pxBlock ), &ulFl, &ulSl );
+
+    if( pxBlock->pxPrevFree != NULL )
+    {
+        pxBlock->pxPrevFree->pxNextFree = pxBlock->pxNextFree;
+    }
+    else
+    {
+        pxFreeLists[ ulFl ][ ulSl ] = pxBlock->pxNextFree;
+
+        if( pxBlock->pxNextFree == NULL )
+        {
+            ulSlBitmap[ ulFl ] &= ~( 1u << ulSl );
+
+            if( ulSlBitmap[ ulFl ] == 0 )
+            {
+                ulFlBitmap &= ~( 1u << ulFl );
+            }
+        }
+    }
+
+    if( pxBlock->pxNextFree != NULL )
+    {
+        pxBlock->pxNextFree->pxPrevFree = pxBlock->pxPrevFree;
+    }
+
+    pxBlock->xSize &= ~tlsfFREE_BIT;
+    xTelemetry.xFreeBlocks--;
+}
+
+static Block_t * prvFindSuitable( size_t xSize )
+{
+    uint32_t ulFl, ulSl, ulSlMap;
+
+    if( prvMappingSearch( xSize, &ulFl, &ulSl ) == pdFALSE )
+    {
+        return NULL;
+    }
+
+    ulSlMap = ulSlBitmap[ ulFl ] & ( ~0u << ulSl );
+
+    if( ulSlMap == 0 )
+    {
+        uint32_t ulFlMap = ulFlBitmap & ( ~0u << ( ulFl + 1 ) );
+
+        if( ulFlMap == 0 )
+        {
+            return NULL;
+        }
+
+        ulFl = ( uint32_t ) __builtin_ctz( ulFlMap );
+        ulSlMap = ulSlBitmap[ ulFl ];
+    }
+
+    ulSl = ( uint32_t ) __builtin_ctz( ulSlMap );
+
+    return pxFreeLists[ ulFl ][ ulSl ];
+}
+
+/* One free block spanning the heap, closed by a zero sized, used sentinel
+ * so prvNextPhys() never runs off the end. */
+static void prvHeapInit( void )
+{
+    uintptr_t uxStart = ( ( uintptr_t ) ucHeap + tlsfALIGN - 1 ) & ~( uintptr_t ) ( tlsfALIGN - 1 );
+    uintptr_t uxEnd = ( ( uintptr_t ) ucHeap + configTOTAL_HEAP_SIZE ) & ~( uintptr_t ) ( tlsfALIGN - 1 );
+    Block_t * pxFirst = ( Block_t * ) uxStart;
+    Block_t * pxSentinel = ( Block_t * ) ( uxEnd - tlsfHEADER );
+
+    pxFirst->pxPrevPhys = NULL;
+    pxFirst->xSize = ( size_t ) ( ( uintptr_t ) pxSentinel - uxStart ) - tlsfHEADER;
+    pxSentinel->pxPrevPhys = pxFirst;
+    pxSentinel->xSize = 0;
+
+    /* The largest class bounds the biggest block the lists can hold:
+     * prvMappingInsert gives fl = fls - tlsfFL_SHIFT + 1, which must stay
+     * below tlsfFL_COUNT, so fls < tlsfFL_MAX_LOG2. */
+    configASSERT( prvFls( prvSize( pxFirst ) ) < tlsfFL_MAX_LOG2 );
+
+    prvInsertFree( pxFirst );
+    xTelemetry.xFreeBytes = prvSize( pxFirst );
+    xMinimumEverFreeBytes = xTelemetry.xFreeBytes;
+    xHeapReady = pdTRUE;
+}
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    Block_t * pxBlock = NULL;
+    void * pvReturn = NULL;
+    size_t xSize;
+
+    vTaskSuspendAll();
+    {
+        if( xHeapReady == pdFALSE )
+        {
+            prvHeapInit();
+        }
+
+        if( ( xWantedSize > 0 ) && ( xWantedSize < configTOTAL_HEAP_SIZE ) )
+        {
+            xSize = ( xWantedSize + tlsfALIGN - 1 ) & ~( tlsfALIGN - 1 );
+
+            if( xSize < tlsfMIN_PAYLOAD )
+            {
+                xSize = tlsfMIN_PAYLOAD;
+            }
+
+            pxBlock = prvFindSuitable( xSize );
+        }
+
+        if( pxBlock != NULL )
+        {
+            size_t xBlockSize = prvSize( pxBlock );
+
+            prvRemoveFree( pxBlock );
+
+            if( xBlockSize - xSize >= tlsfHEADER + tlsfMIN_PAYLOAD )
+            {
+                Block_t * pxRest = ( Block_t * ) ( ( uint8_t * ) pxBlock + tlsfHEADER + xSize );
+
+                pxRest->xSize = xBlockSize - xSize - tlsfHEADER;
+                pxRest->pxPrevPhys = pxBlock;
+                pxBlock->xSize = xSize;
+                prvNextPhys( pxRest )->pxPrevPhys = pxRest;
+                prvInsertFree( pxRest );
+                xTelemetry.xFreeBytes -= xSize + tlsfHEADER;
+            }
+            else
+            {
+                xTelemetry.xFreeBytes -= xBlockSize;
+            }
+
+            xTelemetry.xBytesInUse += prvSize( pxBlock );
+            xTelemetry.xAllocations++;
+
+            if( xTelemetry.xBytesInUse > xTelemetry.xPeakBytesInUse )
+            {
+                xTelemetry.xPeakBytesInUse = xTelemetry.xBytesInUse;
+            }
+
+            if( xTelemetry.xFreeBytes < xMinimumEverFreeBytes )
+            {
+                xMinimumEverFreeBytes = xTelemetry.xFreeBytes;
+            }
+
+            pvReturn = ( uint8_t * ) pxBlock + tlsfHEADER;
+            traceMALLOC( pvReturn, xWantedSize );
+        }
+        else if( xWantedSize > 0 )
+        {
+            xTelemetry.xFailedAllocations++;
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+        {
+            if( pvReturn == NULL )
+            {
+                extern void vApplicationMallocFailedHook( void );
+                vApplicationMallocFailedHook();
+            }
+        }
+    #endif
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    Block_t * pxBlock;
+    Block_t * pxNeighbour;
+
+    if( pv == NULL )
+    {
+        return;
+    }
+
+    pxBlock = ( Block_t * ) ( ( uint8_t * ) pv - tlsfHEADER );
+    configASSERT( prvIsFree( pxBlock ) == pdFALSE );
+
+    vTaskSuspendAll();
+    {
+        xTelemetry.xBytesInUse -= prvSize( pxBlock );
+        xTelemetry.xFreeBytes += prvSize( pxBlock );
+        xTelemetry.xFrees++;
+        traceFREE( pv, prvSize( pxBlock ) );
+
+        pxNeighbour = prvNextPhys( pxBlock );
+
+        if( prvIsFree( pxNeighbour ) )
+        {
+            prvRemoveFree( pxNeighbour );
+            pxBlock->xSize += tlsfHEADER + prvSize( pxNeighbour );
+            prvNextPhys( pxBlock )->pxPrevPhys = pxBlock;
+            xTelemetry.xFreeBytes += tlsfHEADER;
+        }
+
+        pxNeighbour = pxBlock->pxPrevPhys;
+
+        if( ( pxNeighbour != NULL ) && prvIsFree( pxNeighbour ) )
+        {
+            prvRemoveFree( pxNeighbour );
+            pxNeighbour->xSize += tlsfHEADER + prvSize( pxBlock );
+            prvNextPhys( pxNeighbour )->pxPrevPhys = pxNeighbour;
+            pxBlock = pxNeighbour;
+            xTelemetry.xFreeBytes += tlsfHEADER;
+        }
+
+        prvInsertFree( pxBlock );
+    }
+    ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xTelemetry.xFreeBytes;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytes;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+/* Largest free block: the highest non-empty class, then the biggest block
+ * in that one list (blocks in a class differ by less than one step). */
+static size_t prvLargestFree( void )
+{
+    size_t xLargest = 0;
+    Block_t * pxBlock;
+    uint32_t ulFl;
+
+    if( ulFlBitmap == 0 )
+    {
+        return 0;
+    }
+
+    ulFl = 31u - ( uint32_t ) __builtin_clz( ulFlBitmap );
+    pxBlock = pxFreeLists[ ulFl ][ 31u - ( uint32_t ) __builtin_clz( ulSlBitmap[ ulFl ] ) ];
+
+    for( ; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+    {
+        if( prvSize( pxBlock ) > xLargest )
+        {
+            xLargest = prvSize( pxBlock );
+        }
+    }
+
+    return xLargest;
+}
+
+void vPortGetHeapTelemetry( HeapTelemetry_t * pxTelemetry )
+{
+    vTaskSuspendAll();
+    {
+        if( xHeapReady == pdFALSE )
+        {
+            prvHeapInit();
+        }
+
+        *pxTelemetry = xTelemetry;
+        pxTelemetry->xLargestFreeBlock = prvLargestFree();
+    }
+    ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    size_t xSmallest = 0;
+    Block_t * pxBlock;
+    uint32_t ulFl;
+
+    vTaskSuspendAll();
+    {
+        if( xHeapReady == pdFALSE )
+        {
+            prvHeapInit();
+        }
+
+        if( ulFlBitmap != 0 )
+        {
+            ulFl = ( uint32_t ) __builtin_ctz( ulFlBitmap );
+            pxBlock = pxFreeLists[ ulFl ][ __builtin_ctz( ulSlBitmap[ ulFl ] ) ];
+            xSmallest = prvSize( pxBlock );
+
+            for( ; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+            {
+                if( prvSize( pxBlock ) < xSmallest )
+                {
+                    xSmallest = prvSize( pxBlock );
+                }
+            }
+        }
+
+        pxHeapStats->xAvailableHeapSpaceInBytes = xTelemetry.xFreeBytes;
+        pxHeapStats->xSizeOfLargestFreeBlockInBytes = prvLargestFree();
+        pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xSmallest;
+        pxHeapStats->xNumberOfFreeBlocks = xTelemetry.xFreeBlocks;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytes;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xTelemetry.xAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xTelemetry.xFrees;
+    }
+    ( void ) xTaskResumeAll();
+}
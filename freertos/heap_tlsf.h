@@ -0,0 +1,21 @@
+#ifndef HEAP_TLSF_H
+#define HEAP_TLSF_H
+
+#include <stddef.h>
+
+/* Heap telemetry exported by heap_tlsf.c. */
+typedef struct HeapTelemetry
+{
+    size_t xBytesInUse;          /* Block sizes handed out, after rounding. */
+    size_t xPeakBytesInUse;
+    size_t xFreeBytes;           /* Payload bytes still available. */
+    size_t xLargestFreeBlock;    /* Biggest single allocation that would fit. */
+    size_t xFreeBlocks;
+    size_t xAllocations;
+    size_t xFrees;
+    size_t xFailedAllocations;
+} HeapTelemetry_t;
+
+void vPortGetHeapTelemetry( HeapTelemetry_t * pxTelemetry );
+
+#endif /* HEAP_TLSF_H */
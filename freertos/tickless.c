@@ -0,0 +1,155 @@
+/*
+ * Tickless idle for the RP2040, replacing the weak SysTick-only
+ * vPortSuppressTicksAndSleep() in port.c.
+ *
+ * SysTick is 24 bits wide, so at 133 MHz the stock implementation cannot
+ * sleep for more than ~126 ms and loses a few counts every time it is
+ * stopped.  Here the wake-up is a hardware alarm on the 1 MHz system timer
+ * (64 bits, never stopped), and the time actually slept is read back from
+ * that same timer, so the kernel tick count does not drift however long
+ * or short the sleep was.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tickless.h"
+
+#include "hardware/timer.h"
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+#define portNVIC_SYSTICK_CTRL_REG             ( *( ( volatile uint32_t * ) 0xe000e010 ) )
+#define portNVIC_SYSTICK_LOAD_REG             ( *( ( volatile uint32_t * ) 0xe000e014 ) )
+#define portNVIC_SYSTICK_CURRENT_VALUE_REG    ( *( ( volatile uint32_t * ) 0xe000e018 ) )
+#define portNVIC_SYSTICK_ENABLE_BIT           ( 1UL << 0UL )
+
+#define tickUS_PER_TICK                       ( 1000000UL / configTICK_RATE_HZ )
+#define tickCOUNTS_PER_TICK                   ( configCPU_CLOCK_HZ / configTICK_RATE_HZ )
+#define tickCOUNTS_PER_US                     ( configCPU_CLOCK_HZ / 1000000UL )
+
+/* Longest single sleep; the alarm itself could go much further. */
+#define tickMAX_SUPPRESSED_TICKS              ( ( TickType_t ) ( 10UL * configTICK_RATE_HZ ) )
+
+static int xWakeAlarm = -1;
+static TicklessStats_t xStats;
+
+static void prvWakeAlarmCallback( uint alarm_num )
+{
+    /* Nothing to do: the interrupt itself ends the wfi. */
+    ( void ) alarm_num;
+}
+
+static void prvRestartSysTick( uint32_t ulCounts )
+{
+    /* Next tick after ulCounts, then back to normal periods. */
+    portNVIC_SYSTICK_LOAD_REG = ulCounts - 1UL;
+    portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
+    portNVIC_SYSTICK_CTRL_REG |= portNVIC_SYSTICK_ENABLE_BIT;
+    portNVIC_SYSTICK_LOAD_REG = tickCOUNTS_PER_TICK - 1UL;
+}
+
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+    uint64_t ullStart, ullSlept;
+    uint32_t ulIntoTickUs, ulRemainderUs;
+    TickType_t xCompleteTicks;
+
+    if( xWakeAlarm < 0 )
+    {
+        xWakeAlarm = hardware_alarm_claim_unused( false );
+
+        if( xWakeAlarm < 0 )
+        {
+            return; /* All alarms taken: plain idle with the tick running. */
+        }
+
+        hardware_alarm_set_callback( xWakeAlarm, prvWakeAlarmCallback );
+    }
+
+    if( xExpectedIdleTime > tickMAX_SUPPRESSED_TICKS )
+    {
+        xExpectedIdleTime = tickMAX_SUPPRESSED_TICKS;
+    }
+
+    __asm volatile ( "cpsid i" ::: "memory" );
+    __asm volatile ( "dsb" );
+    __asm volatile ( "isb" );
+
+    if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+    {
+        xStats.ulAborted++;
+        __asm volatile ( "cpsie i" ::: "memory" );
+        return;
+    }
+
+    /* Freeze the tick and note how far into the current period we are. */
+    portNVIC_SYSTICK_CTRL_REG &= ~portNVIC_SYSTICK_ENABLE_BIT;
+    ullStart = time_us_64();
+    ulIntoTickUs = ( tickCOUNTS_PER_TICK - 1UL - portNVIC_SYSTICK_CURRENT_VALUE_REG ) / tickCOUNTS_PER_US;
+
+    /* set_target returns true if the deadline already passed. */
+    if( hardware_alarm_set_target( xWakeAlarm,
+                                   from_us_since_boot( ullStart + ( uint64_t ) xExpectedIdleTime * tickUS_PER_TICK - ulIntoTickUs ) ) == false )
+    {
+        __asm volatile ( "dsb" ::: "memory" );
+        __asm volatile ( "wfi" );
+        __asm volatile ( "isb" );
+    }
+
+    /* Woken by the alarm or by any other interrupt (GPIO, hrtimer, USB). */
+    hardware_alarm_cancel( xWakeAlarm );
+    ullSlept = time_us_64() - ullStart;
+    xCompleteTicks = ( TickType_t ) ( ( ullSlept + ulIntoTickUs ) / tickUS_PER_TICK );
+    ulRemainderUs = ( uint32_t ) ( ( ullSlept + ulIntoTickUs ) % tickUS_PER_TICK );
+
+    if( xCompleteTicks >= xExpectedIdleTime )
+    {
+        TickType_t x;
+
+        /* vTaskStepTick may not cross the expected wake-up tick. That tick
+         * and any overshoot past it are pended instead: the scheduler is
+         * suspended here, so xTaskIncrementTick only counts them, and the
+         * idle task's xTaskResumeAll runs them, unblocking the waiter. */
+        vTaskStepTick( xExpectedIdleTime - 1UL );
+
+        for( x = xExpectedIdleTime - 1UL; x < xCompleteTicks; x++ )
+        {
+            ( void ) xTaskIncrementTick();
+        }
+    }
+    else
+    {
+        vTaskStepTick( xCompleteTicks );
+    }
+
+    /* Either way the next tick keeps the phase of the ticks before. */
+    prvRestartSysTick( ( tickUS_PER_TICK - ulRemainderUs ) * tickCOUNTS_PER_US );
+
+    xStats.ulSleeps++;
+    xStats.ullSleptUs += ullSlept;
+
+    if( ullSlept > xStats.ulMaxSleepUs )
+    {
+        xStats.ulMaxSleepUs = ( uint32_t ) ullSlept;
+    }
+
+    __asm volatile ( "cpsie i" ::: "memory" );
+}
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+void vPortGetTicklessStats( TicklessStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        #if ( configUSE_TICKLESS_IDLE == 1 )
+            *pxStats = xStats;
+        #else
+            pxStats->ulSleeps = 0;
+            pxStats->ulAborted = 0;
+            pxStats->ullSleptUs = 0;
+            pxStats->ulMaxSleepUs = 0;
+        #endif
+    }
+    taskEXIT_CRITICAL();
+}
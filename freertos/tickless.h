@@ -0,0 +1,17 @@
+#ifndef TICKLESS_H
+#define TICKLESS_H
+
+#include <stdint.h>
+
+/* Tickless idle statistics exported by tickless.c. */
+typedef struct TicklessStats
+{
+    uint32_t ulSleeps;          /* Times the idle task stopped the tick. */
+    uint32_t ulAborted;         /* Sleeps abandoned before the wfi. */
+    uint64_t ullSleptUs;        /* Total time spent in wfi with the tick off. */
+    uint32_t ulMaxSleepUs;
+} TicklessStats_t;
+
+void vPortGetTicklessStats( TicklessStats_t * pxStats );
+
+#endif /* TICKLESS_H */
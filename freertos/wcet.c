@@ -0,0 +1,78 @@
+/*
+ * Task execution time accounting for wcet.h, fed by the
+ * traceTASK_SWITCHED_OUT/IN hooks set in FreeRTOSConfig.h.
+ */
+
+#include "wcet.h"
+
+#include "hardware/timer.h"
+
+void vWcetSwitchedOut( void )
+{
+    WcetSlot_t * pxSlot = pvTaskGetThreadLocalStoragePointer( NULL, configWCET_TLS_INDEX );
+
+    if( pxSlot != NULL )
+    {
+        pxSlot->ulOutAtUs = time_us_32();
+    }
+}
+
+void vWcetSwitchedIn( void )
+{
+    WcetSlot_t * pxSlot = pvTaskGetThreadLocalStoragePointer( NULL, configWCET_TLS_INDEX );
+
+    if( pxSlot != NULL )
+    {
+        pxSlot->ulOffUs += time_us_32() - pxSlot->ulOutAtUs;
+    }
+}
+
+void vWcetAttach( TaskHandle_t xTask, WcetSlot_t * pxSlot )
+{
+    vTaskSetThreadLocalStoragePointer( xTask, configWCET_TLS_INDEX, pxSlot );
+}
+
+void vWcetBegin( WcetSlot_t * pxSlot )
+{
+    pxSlot->ulStartUs = time_us_32();
+    pxSlot->ulOffAtStartUs = pxSlot->ulOffUs;
+}
+
+BaseType_t xWcetEnd( WcetSlot_t * pxSlot )
+{
+    /* Switched-out time first: a preemption between the two reads then
+     * inflates the execution time instead of hiding part of it. */
+    uint32_t ulOff = pxSlot->ulOffUs - pxSlot->ulOffAtStartUs;
+    uint32_t ulResponse = time_us_32() - pxSlot->ulStartUs;
+    uint32_t ulExec = ( ulResponse > ulOff ) ? ulResponse - ulOff : 0;
+
+    pxSlot->ulLastUs = ulExec;
+    pxSlot->ulRuns++;
+
+    if( ulExec > pxSlot->ulWcetUs )
+    {
+        pxSlot->ulWcetUs = ulExec;
+    }
+
+    if( ulResponse > pxSlot->ulMaxResponseUs )
+    {
+        pxSlot->ulMaxResponseUs = ulResponse;
+    }
+
+    if( ( pxSlot->ulDeadlineUs != 0 ) && ( ulResponse > pxSlot->ulDeadlineUs ) )
+    {
+        pxSlot->ulMisses++;
+        return pdFALSE;
+    }
+
+    return pdTRUE;
+}
+
+void vWcetReset( WcetSlot_t * pxSlot )
+{
+    pxSlot->ulWcetUs = 0;
+    pxSlot->ulLastUs = 0;
+    pxSlot->ulMaxResponseUs = 0;
+    pxSlot->ulRuns = 0;
+    pxSlot->ulMisses = 0;
+}
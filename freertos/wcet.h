@@ -0,0 +1,53 @@
+#ifndef WCET_H
+#define WCET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*
+ * Execution time of task loop bodies, measured on the 1 MHz RP2040 timer.
+ *
+ * A task brackets one iteration with vWcetBegin() (right after the call
+ * that blocked it returns) and xWcetEnd() (right before it blocks again).
+ * The kernel's switched-in/out trace hooks add up the time the task spent
+ * switched out in between, so the execution time excludes preemption and
+ * blocking inside the body; interrupts that hit the task still count.
+ * The response time (begin to end, everything included) is checked
+ * against the slot's deadline.
+ */
+
+typedef struct WcetSlot
+{
+    const char * pcId;          /* Task table row id. */
+    uint32_t ulPeriodUs;        /* Period or minimum inter-arrival time. */
+    uint32_t ulDeadlineUs;      /* Relative to vWcetBegin(). */
+
+    uint32_t ulWcetUs;          /* Worst execution time of one body. */
+    uint32_t ulLastUs;
+    uint32_t ulMaxResponseUs;
+    uint32_t ulRuns;
+    uint32_t ulMisses;          /* Bodies that ended past the deadline. */
+
+    /* Private. */
+    uint32_t ulStartUs;
+    uint32_t ulOffAtStartUs;
+    volatile uint32_t ulOffUs;
+    volatile uint32_t ulOutAtUs;
+} WcetSlot_t;
+
+/* Binds the slot to xTask (thread local storage pointer
+ * configWCET_TLS_INDEX). */
+void vWcetAttach( TaskHandle_t xTask, WcetSlot_t * pxSlot );
+
+void vWcetBegin( WcetSlot_t * pxSlot );
+
+/* pdFALSE if the body missed its deadline. */
+BaseType_t xWcetEnd( WcetSlot_t * pxSlot );
+
+/* Clears the measured figures (not the period or deadline). */
+void vWcetReset( WcetSlot_t * pxSlot );
+
+#endif /* WCET_H */
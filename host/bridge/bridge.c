@@ -0,0 +1,122 @@
+#include "bridge.h"
+
+#include <string.h>
+#include <linux/input-event-codes.h>
+
+void bridge_init(bridge_t *b, sink_t *sink) {
+    memset(b, 0, sizeof *b);
+    b->sink = sink;
+}
+
+static void emit(bridge_t *b, uint16_t type, uint16_t code, int32_t value) {
+    if (!sink_emit(b->sink, type, code, value)) b->stats.sink_errors++;
+}
+
+static void syn(bridge_t *b) {
+    emit(b, EV_SYN, SYN_REPORT, 0);
+    b->stats.reports++;
+}
+
+static void tap(bridge_t *b, uint16_t key) {
+    if (b->ntaps == BRIDGE_MAX_TAPS) bridge_flush(b);
+    b->taps[b->ntaps++] = key;
+    b->dirty = true;
+}
+
+static uint16_t button_key(uint8_t code) {
+    switch (code) {
+    case ' ': return KEY_SPACE;
+    case 'R': return KEY_R;
+    case 'E': return KEY_E;
+    case 1:   return BTN_RIGHT;
+    case 2:   return KEY_LEFTSHIFT;
+    default:  return 0;
+    }
+}
+
+// direcional_task sends 'A' for the negative side and 'S' for the
+// positive side on both axes; 'D' and 'W' are accepted too.
+static uint16_t dir_key(uint8_t axis, uint8_t cmd) {
+    if (axis == 0) {
+        if (cmd == 'A') return KEY_A;
+        if (cmd == 'D' || cmd == 'S') return KEY_D;
+    } else {
+        if (cmd == 'W' || cmd == 'A') return KEY_W;
+        if (cmd == 'S') return KEY_S;
+    }
+    return 0;
+}
+
+static void hold(bridge_t *b, int axis, uint16_t key, uint64_t now_us) {
+    b->held_at_us[axis] = now_us;
+    if (b->held[axis] == key) return;
+    if (b->held[axis]) emit(b, EV_KEY, b->held[axis], 0);
+    emit(b, EV_KEY, key, 1);
+    b->held[axis] = key;
+    b->dirty = true;
+}
+
+void bridge_packet(bridge_t *b, const packet_t *p, uint64_t now_us) {
+    b->stats.packets++;
+    switch (p->hdr) {
+    case PKT_AXIS_HDR:
+        if (p->id == 0) b->dx += p->val;
+        else if (p->id == 1) b->dy += p->val;
+        else if (p->id == 2) tap(b, p->val > 0 ? KEY_RIGHT : KEY_LEFT);
+        else if (p->id == 3) tap(b, p->val > 0 ? KEY_DOWN : KEY_UP);
+        b->dirty = true;
+        break;
+    case PKT_BUTTON_HDR: {
+        uint16_t key = button_key(p->id);
+        if (key && p->val == 1) tap(b, key);
+        break;
+    }
+    case PKT_DIR_HDR: {
+        int axis = p->id ? 1 : 0;
+        uint16_t key = dir_key(p->id, (uint8_t)p->val);
+        if (key) hold(b, axis, key, now_us);
+        else b->held_at_us[axis] = now_us;
+        break;
+    }
+    }
+}
+
+void bridge_flush(bridge_t *b) {
+    if (!b->dirty) return;
+    if (b->dx) emit(b, EV_REL, REL_X, b->dx);
+    if (b->dy) emit(b, EV_REL, REL_Y, b->dy);
+    for (int i = 0; i < b->ntaps; i++) emit(b, EV_KEY, b->taps[i], 1);
+    syn(b);
+    if (b->ntaps) {
+        for (int i = 0; i < b->ntaps; i++) emit(b, EV_KEY, b->taps[i], 0);
+        syn(b);
+    }
+    b->dx = b->dy = 0;
+    b->ntaps = 0;
+    b->dirty = false;
+}
+
+bool bridge_expire(bridge_t *b, uint64_t now_us) {
+    bool any = false;
+    for (int axis = 0; axis < 2; axis++) {
+        if (b->held[axis] && now_us - b->held_at_us[axis] >= BRIDGE_DIR_TIMEOUT_US) {
+            emit(b, EV_KEY, b->held[axis], 0);
+            b->held[axis] = 0;
+            any = true;
+        }
+    }
+    if (any) {
+        b->dirty = true;
+        bridge_flush(b);
+    }
+    return any;
+}
+
+uint64_t bridge_release_at(const bridge_t *b, int axis) {
+    return b->held[axis] ? b->held_at_us[axis] + BRIDGE_DIR_TIMEOUT_US : 0;
+}
+
+void bridge_release_all(bridge_t *b) {
+    bridge_flush(b);
+    bridge_expire(b, UINT64_MAX);
+}
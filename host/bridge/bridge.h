@@ -0,0 +1,57 @@
+#ifndef BRIDGE_H
+#define BRIDGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "packet.h"
+#include "sink.h"
+
+// A held direction key is released when its packets stop for this long
+// (main.py's TIMEOUT).
+#define BRIDGE_DIR_TIMEOUT_US  300000u
+#define BRIDGE_MAX_TAPS        8
+
+typedef struct {
+    uint32_t packets;
+    uint32_t reports;      // SYN_REPORTs written
+    uint32_t sink_errors;
+} bridge_stats_t;
+
+// Packets -> input events. Packets that arrive together (one read from
+// the serial port) make one frame: their mouse deltas are summed and the
+// whole frame goes out under a single SYN_REPORT. Button "presses" are
+// taps, like pyautogui.press: the key goes down in the frame and up in a
+// second report right after it.
+typedef struct {
+    sink_t *sink;
+    int32_t dx, dy;
+    uint16_t taps[BRIDGE_MAX_TAPS];
+    int ntaps;
+    uint16_t held[2];          // direction key per axis, 0 = none
+    uint64_t held_at_us[2];    // last packet that refreshed it
+    bool dirty;
+    bridge_stats_t stats;
+} bridge_t;
+
+void bridge_init(bridge_t *b, sink_t *sink);
+
+// Adds one packet to the current frame.
+void bridge_packet(bridge_t *b, const packet_t *p, uint64_t now_us);
+
+// Ends the frame: writes its events and the SYN_REPORT. No-op if the
+// frame is empty.
+void bridge_flush(bridge_t *b);
+
+// Releases direction keys whose last packet is BRIDGE_DIR_TIMEOUT_US old
+// at now_us. Returns true if anything was released.
+bool bridge_expire(bridge_t *b, uint64_t now_us);
+
+// When the direction key on axis (0/1) is due for release if no packet
+// refreshes it; 0 if none is held.
+uint64_t bridge_release_at(const bridge_t *b, int axis);
+
+// Releases everything still held (exit, device gone).
+void bridge_release_all(bridge_t *b);
+
+#endif // BRIDGE_H
@@ -0,0 +1,113 @@
+#include "capture.h"
+
+#include <string.h>
+#include <time.h>
+
+#define HEADER_SIZE (8 + 4 + 4 + 8 + 32)
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static size_t put_varint(uint8_t *p, uint64_t v) {
+    size_t n = 0;
+    do {
+        p[n] = v & 0x7f;
+        v >>= 7;
+        if (v) p[n] |= 0x80;
+        n++;
+    } while (v);
+    return n;
+}
+
+static bool get_varint(FILE *f, uint64_t *v) {
+    *v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(f);
+        if (c == EOF) return false;
+        *v |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+bool capture_open(capture_t *c, const char *path, const char *label, uint64_t now_us) {
+    uint8_t hdr[HEADER_SIZE] = { 0 };
+    struct timespec ts;
+    memset(c, 0, sizeof *c);
+    c->f = fopen(path, "wb");
+    if (!c->f) {
+        perror(path);
+        return false;
+    }
+    setvbuf(c->f, NULL, _IOFBF, 1 << 16);
+    clock_gettime(CLOCK_REALTIME, &ts);
+    memcpy(hdr, CAPTURE_MAGIC, 8);
+    put_u32(hdr + 8, CAPTURE_VERSION);
+    put_u64(hdr + 16, (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+    strncpy((char *)hdr + 24, label, 31);
+    c->last_us = now_us;
+    return fwrite(hdr, 1, sizeof hdr, c->f) == sizeof hdr;
+}
+
+bool capture_write(capture_t *c, uint64_t t_us, const uint8_t *buf, size_t len) {
+    uint8_t head[20];
+    size_t n = put_varint(head, t_us - c->last_us);
+    n += put_varint(head + n, len);
+    c->last_us = t_us;
+    c->records++;
+    c->bytes += len;
+    return fwrite(head, 1, n, c->f) == n && fwrite(buf, 1, len, c->f) == len;
+}
+
+void capture_close(capture_t *c) {
+    if (c->f) fclose(c->f);
+    c->f = NULL;
+}
+
+bool capture_reader_open(capture_reader_t *r, const char *path) {
+    uint8_t hdr[HEADER_SIZE];
+    memset(r, 0, sizeof *r);
+    r->f = fopen(path, "rb");
+    if (!r->f) return false;
+    if (fread(hdr, 1, sizeof hdr, r->f) != sizeof hdr || memcmp(hdr, CAPTURE_MAGIC, 8) ||
+        get_u32(hdr + 8) != CAPTURE_VERSION) {
+        fclose(r->f);
+        r->f = NULL;
+        return false;
+    }
+    r->start_realtime_us = get_u64(hdr + 16);
+    memcpy(r->label, hdr + 24, 31);
+    return true;
+}
+
+long capture_next(capture_reader_t *r, uint64_t *t_us, uint8_t buf[CAPTURE_MAX_READ]) {
+    uint64_t dt, len;
+    if (!get_varint(r->f, &dt)) return 0;
+    if (!get_varint(r->f, &len) || len > CAPTURE_MAX_READ || fread(buf, 1, len, r->f) != len)
+        return -1;
+    r->t_us += dt;
+    *t_us = r->t_us;
+    return (long)len;
+}
+
+void capture_reader_close(capture_reader_t *r) {
+    if (r->f) fclose(r->f);
+    r->f = NULL;
+}
@@ -0,0 +1,50 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Raw serial stream with host receive times, as `bridge --capture`
+// records it and `replay` plays it back.
+//
+//   header  "PECAP1\0\0", u32 version, u32 reserved, u64 start time
+//           (CLOCK_REALTIME µs, for the record only), char label[32]
+//   record  varint µs since the previous record (the first: since start),
+//           varint length, the bytes one read() returned
+//
+// Integers are little-endian; varints are LEB128. A 500 Hz stream costs
+// about two bytes per read on top of the data.
+
+#define CAPTURE_MAGIC     "PECAP1\0\0"
+#define CAPTURE_VERSION   1
+#define CAPTURE_MAX_READ  4096
+
+typedef struct {
+    FILE *f;
+    uint64_t last_us;       // CLOCK_MONOTONIC of the previous record
+    uint64_t records, bytes;
+} capture_t;
+
+// Starts a capture; now_us is CLOCK_MONOTONIC at the start.
+bool capture_open(capture_t *c, const char *path, const char *label, uint64_t now_us);
+bool capture_write(capture_t *c, uint64_t t_us, const uint8_t *buf, size_t len);
+void capture_close(capture_t *c);
+
+typedef struct {
+    FILE *f;
+    uint64_t t_us;          // time of the last record, from the start
+    uint64_t start_realtime_us;
+    char label[32];
+} capture_reader_t;
+
+// False if path is not a capture (e.g. a plain byte dump).
+bool capture_reader_open(capture_reader_t *r, const char *path);
+
+// Next record: *t_us is its time since the start of the capture. Returns
+// the length, 0 at the end, -1 if the file is corrupt.
+long capture_next(capture_reader_t *r, uint64_t *t_us, uint8_t buf[CAPTURE_MAX_READ]);
+void capture_reader_close(capture_reader_t *r);
+
+#endif // CAPTURE_H
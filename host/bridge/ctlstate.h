@@ -0,0 +1,88 @@
+#ifndef CTLSTATE_H
+#define CTLSTATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Live controller state published by `bridge --shm` in a POSIX shared
+// memory segment, one per controller: /pico_emb.<label>, where label is
+// the board's USB serial (or the tty name). Readers map it read-only and
+// never make a syscall per read, nor can they hold the bridge up.
+//
+// The state block is guarded by a seqlock: the bridge makes `seq` odd,
+// writes, and makes it even again; a reader copies the block and retries
+// only if `seq` changed under it. The event ring holds the last
+// CTL_RING_SIZE packets; each slot carries the sequence number of the
+// event in it, so a reader that fell behind by more than a ring sees the
+// gap instead of torn data.
+//
+// Link against libctlstate (ctlstate_client.c); this header is all a
+// consumer needs.
+
+#define CTL_MAGIC      0x43544c31u     // "CTL1"
+#define CTL_VERSION    1
+#define CTL_RING_SIZE  256             // power of two
+#define CTL_SHM_PREFIX "/pico_emb."
+
+// Button bitmask, one bit per button code of the B0 packet.
+#define CTL_BTN_SPACE  (1u << 0)       // ' '
+#define CTL_BTN_R      (1u << 1)       // 'R'
+#define CTL_BTN_E      (1u << 2)       // 'E'
+#define CTL_BTN_RIGHT  (1u << 3)       // 1: right click
+#define CTL_BTN_SHIFT  (1u << 4)       // 2: shift
+
+typedef struct {
+    uint64_t frame;         // frames published so far
+    uint64_t packets;
+    uint64_t t_rx_us;       // host CLOCK_MONOTONIC when the frame's read returned
+    uint64_t t_pub_us;      // ... and when it was published
+    int32_t  pos_x, pos_y;  // sum of all axis deltas
+    int16_t  dx, dy;        // last delta per axis
+    uint32_t buttons;       // CTL_BTN_* pressed in this frame (taps; the
+                            // ring has every press)
+    uint8_t  dir[2];        // held WASD letter per axis, 0 = none
+    uint8_t  attached;      // 0 while the controller is unplugged
+    uint8_t  pad;
+} ctl_state_t;
+
+typedef struct {
+    uint64_t seq;           // 1-based event number; 0 = slot being written
+    uint64_t t_us;          // host receive time
+    uint8_t  hdr, id;       // packet as decoded (packet.h)
+    int16_t  val;
+    uint32_t pad;
+} ctl_event_t;
+
+typedef struct {
+    uint32_t magic, version;
+    uint32_t ring_size;
+    uint32_t pid;           // bridge process
+    char     label[32];
+    uint32_t seq;           // seqlock over `state`
+    uint32_t pad;
+    ctl_state_t state;
+    uint64_t head;          // events written so far
+    ctl_event_t ring[CTL_RING_SIZE];
+} ctl_shm_t;
+
+typedef struct ctlstate ctlstate_t;
+
+// Maps /pico_emb.<label> read-only; NULL if there is none or it is not
+// a segment of this version.
+ctlstate_t *ctlstate_open(const char *label);
+void ctlstate_close(ctlstate_t *c);
+
+// Direct read-only view of the segment.
+const ctl_shm_t *ctlstate_shm(const ctlstate_t *c);
+
+// Consistent copy of the state block; returns the retries it took.
+unsigned ctlstate_read(const ctlstate_t *c, ctl_state_t *out);
+
+// Copies up to max events after *cursor (0 = from the oldest still in the
+// ring) and advances it. *lost counts events overwritten before they
+// were read. Returns the number copied.
+size_t ctlstate_events(const ctlstate_t *c, uint64_t *cursor, ctl_event_t *out,
+                       size_t max, uint64_t *lost);
+
+#endif // CTLSTATE_H
@@ -0,0 +1,132 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bridge.h"
+#include "ctlstate.h"
+#include "shm_export.h"
+#include "sink.h"
+
+// ctlstate_bench [--hz N] [--reads N]     own writer thread, N frames/s
+//                                         (0 = as fast as it can)
+// ctlstate_bench --label <serial|tty>     against a running bridge --shm
+//
+// Measures what a reader pays for ctlstate_read (ns per call, p50/p99/
+// max, seqlock retries), how old the state it gets is (now - t_pub_us),
+// and the event ring's read rate. One key=value line per measurement.
+
+#define BENCH_LABEL "ctlstate_bench"
+
+static volatile int stop;
+static uint32_t writer_hz = 1000;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void *writer(void *arg) {
+    shm_export_t *e = arg;
+    bridge_t b;
+    bridge_init(&b, sink_null_open());
+    uint64_t next = now_ns();
+    int16_t v = 1;
+    while (!stop) {
+        uint64_t t = now_ns() / 1000;
+        packet_t px = { PKT_AXIS_HDR, 0, v }, py = { PKT_AXIS_HDR, 1, (int16_t)-v };
+        shm_export_event(e, &px, t);
+        shm_export_event(e, &py, t);
+        shm_export_frame(e, &b, t);
+        v = (int16_t)(v % 200 + 1);
+        if (writer_hz) {
+            next += 1000000000u / writer_hz;
+            struct timespec ts = { (time_t)(next / 1000000000u), (long)(next % 1000000000u) };
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        }
+    }
+    return NULL;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *what, uint32_t *v, size_t n, const char *unit) {
+    qsort(v, n, sizeof *v, cmp_u32);
+    printf("ctlstate_bench measure=%s n=%zu p50_%s=%u p99_%s=%u max_%s=%u\n",
+           what, n, unit, v[n / 2], unit, v[n * 99 / 100], unit, v[n - 1]);
+}
+
+int main(int argc, char **argv) {
+    const char *label = NULL;
+    size_t reads = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--hz") && i + 1 < argc)
+            writer_hz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--reads") && i + 1 < argc)
+            reads = (size_t)atol(argv[++i]);
+        else if (!strcmp(argv[i], "--label") && i + 1 < argc)
+            label = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--hz N] [--reads N] [--label <serial|tty>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    shm_export_t *e = NULL;
+    pthread_t th;
+    if (!label) {
+        label = BENCH_LABEL;
+        e = shm_export_open(label);
+        if (!e) return 1;
+        shm_export_attached(e, true);
+        pthread_create(&th, NULL, writer, e);
+    }
+    ctlstate_t *c = ctlstate_open(label);
+    if (!c) {
+        fprintf(stderr, "no segment " CTL_SHM_PREFIX "%s\n", label);
+        return 1;
+    }
+
+    uint32_t *cost = malloc(reads * sizeof *cost);
+    uint32_t *age = malloc(reads * sizeof *age);
+    if (!cost || !age) return 1;
+    uint64_t retries = 0;
+    ctl_state_t s;
+    for (size_t i = 0; i < reads; i++) {
+        uint64_t t0 = now_ns();
+        retries += ctlstate_read(c, &s);
+        uint64_t t1 = now_ns();
+        cost[i] = (uint32_t)(t1 - t0);
+        age[i] = s.t_pub_us ? (uint32_t)(t1 / 1000 - s.t_pub_us) : 0;
+    }
+    report("read", cost, reads, "ns");
+    report("age", age, reads, "us");
+    printf("ctlstate_bench measure=retries reads=%zu retries=%llu writer_hz=%u frame=%llu\n",
+           reads, (unsigned long long)retries, e ? writer_hz : 0, (unsigned long long)s.frame);
+
+    // Event ring: drain for a while as a consumer would.
+    ctl_event_t evs[64];
+    uint64_t cursor = 0, got = 0, lost_total = 0, lost;
+    uint64_t t0 = now_ns();
+    while (now_ns() - t0 < 500000000u) {
+        got += ctlstate_events(c, &cursor, evs, 64, &lost);
+        lost_total += lost;
+    }
+    printf("ctlstate_bench measure=events read=%llu lost=%llu per_s=%.0f\n",
+           (unsigned long long)got, (unsigned long long)lost_total, got / 0.5);
+
+    stop = 1;
+    if (e) {
+        pthread_join(th, NULL);
+        shm_export_close(e);
+    }
+    ctlstate_close(c);
+    free(cost);
+    free(age);
+    return 0;
+}
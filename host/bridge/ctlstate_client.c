@@ -0,0 +1,91 @@
+#include "ctlstate.h"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+struct ctlstate {
+    const ctl_shm_t *shm;
+};
+
+ctlstate_t *ctlstate_open(const char *label) {
+    char name[64];
+    snprintf(name, sizeof name, CTL_SHM_PREFIX "%s", label);
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    const ctl_shm_t *shm = mmap(NULL, sizeof *shm, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED) return NULL;
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != CTL_MAGIC ||
+        shm->version != CTL_VERSION || shm->ring_size != CTL_RING_SIZE) {
+        munmap((void *)shm, sizeof *shm);
+        return NULL;
+    }
+    ctlstate_t *c = malloc(sizeof *c);
+    if (!c) {
+        munmap((void *)shm, sizeof *shm);
+        return NULL;
+    }
+    c->shm = shm;
+    return c;
+}
+
+void ctlstate_close(ctlstate_t *c) {
+    if (!c) return;
+    munmap((void *)c->shm, sizeof *c->shm);
+    free(c);
+}
+
+const ctl_shm_t *ctlstate_shm(const ctlstate_t *c) {
+    return c->shm;
+}
+
+unsigned ctlstate_read(const ctlstate_t *c, ctl_state_t *out) {
+    const ctl_shm_t *shm = c->shm;
+    unsigned retries = 0;
+    for (;;) {
+        uint32_t s1 = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+        if (!(s1 & 1)) {
+            memcpy(out, (const void *)&shm->state, sizeof *out);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&shm->seq, __ATOMIC_RELAXED) == s1) return retries;
+        }
+        // The writer was preempted mid-update: let it run.
+        if (++retries % 64 == 0) sched_yield();
+    }
+}
+
+size_t ctlstate_events(const ctlstate_t *c, uint64_t *cursor, ctl_event_t *out,
+                       size_t max, uint64_t *lost) {
+    const ctl_shm_t *shm = c->shm;
+    uint64_t head = __atomic_load_n(&shm->head, __ATOMIC_ACQUIRE);
+    uint64_t next = *cursor;
+    size_t n = 0;
+    *lost = 0;
+    if (head > CTL_RING_SIZE && next < head - CTL_RING_SIZE) {
+        if (next) *lost = head - CTL_RING_SIZE - next;
+        next = head - CTL_RING_SIZE;
+    }
+    while (n < max && next < head) {
+        const ctl_event_t *slot = &shm->ring[next % CTL_RING_SIZE];
+        uint64_t want = next + 1;
+        uint64_t s1 = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        memcpy(&out[n], (const void *)slot, sizeof out[n]);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint64_t s2 = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+        if (s1 != want || s2 != want) {
+            // Overwritten while we looked: the writer lapped us.
+            (*lost)++;
+            next++;
+            continue;
+        }
+        n++;
+        next++;
+    }
+    *cursor = next;
+    return n;
+}
@@ -0,0 +1,152 @@
+#include "device.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+
+#define READ_SIZE 4096
+
+static void on_packet(void *ctx, const packet_t *p) {
+    device_t *d = ctx;
+    bridge_packet(&d->bridge, p, d->t_us);
+    if (d->shm) shm_export_event(d->shm, p, d->t_us);
+}
+
+// Arms an axis timer when its key goes down. A packet that refreshes the
+// key does not touch the timer: on expiry the deadline is recomputed and
+// the timer re-armed if the key was refreshed meanwhile, so holding a
+// direction costs one timerfd_settime per BRIDGE_DIR_TIMEOUT_US instead of
+// one per packet.
+static void arm_release(device_t *d) {
+    for (int axis = 0; axis < 2; axis++) {
+        uint64_t at = bridge_release_at(&d->bridge, axis);
+        if (at && !d->release[axis].deadline_us)
+            evloop_timer_arm(&d->release[axis], at);
+    }
+}
+
+static void on_release(void *ctx, uint32_t events) {
+    device_t *d = ctx;
+    uint64_t now = evloop_now_us();
+    (void)events;
+    if (bridge_expire(&d->bridge, now) && d->shm) shm_export_frame(d->shm, &d->bridge, now);
+    arm_release(d);
+}
+
+// Everything one read returned is one frame. t_us is the frame's time on
+// the bridge's clock (the capture's when replaying one); t_rx_us is when
+// it reached us, for the recording and the latency stats.
+static void feed(device_t *d, const uint8_t *buf, size_t n, uint64_t t_us, uint64_t t_rx_us) {
+    d->t_us = t_us;
+    if (d->cap) capture_write(d->cap, t_rx_us, buf, n);
+    parser_feed(&d->parser, buf, n, on_packet, d);
+    bridge_flush(&d->bridge);
+    if (d->shm) shm_export_frame(d->shm, &d->bridge, t_us);
+    uint32_t lat = (uint32_t)(evloop_now_us() - t_rx_us);
+    d->stats.frames++;
+    d->stats.lat_sum_us += lat;
+    if (lat > d->stats.lat_max_us) d->stats.lat_max_us = lat;
+    if (lat > d->stats.lat_peak_us) d->stats.lat_peak_us = lat;
+}
+
+bool device_pump(device_t *d) {
+    static uint8_t buf[READ_SIZE];      // one loop thread: shared by every device
+    ssize_t n = read(d->tty.fd, buf, sizeof buf);
+    if (n > 0) {
+        uint64_t now = evloop_now_us();
+        feed(d, buf, (size_t)n, now, now);
+        arm_release(d);
+        return true;
+    }
+    return n < 0 && (errno == EINTR || errno == EAGAIN);
+}
+
+bool device_pump_capture(device_t *d, capture_reader_t *r) {
+    static uint8_t buf[CAPTURE_MAX_READ];
+    uint64_t t_us;
+    long n = capture_next(r, &t_us, buf);
+    if (n <= 0) return false;
+    // Releases follow the capture's clock instead of the release timers.
+    if (bridge_expire(&d->bridge, t_us) && d->shm) shm_export_frame(d->shm, &d->bridge, t_us);
+    feed(d, buf, (size_t)n, t_us, evloop_now_us());
+    return true;
+}
+
+static void on_tty(void *ctx, uint32_t events) {
+    device_t *d = ctx;
+    // A detach earlier in the same epoll batch leaves a stale event.
+    if (!device_attached(d)) return;
+    if ((events & EPOLLIN) && device_pump(d)) return;
+    if (d->on_gone) d->on_gone(d);
+}
+
+bool device_init(device_t *d, evloop_t *loop, sink_t *sink) {
+    memset(d, 0, sizeof *d);
+    d->loop = loop;
+    d->tty.fd = -1;
+    d->tty.cb = on_tty;
+    d->tty.ctx = d;
+    parser_init(&d->parser);
+    d->sink = sink;
+    bridge_init(&d->bridge, sink);
+    for (int axis = 0; axis < 2; axis++)
+        if (!evloop_timer_init(loop, &d->release[axis], on_release, d)) return false;
+    return true;
+}
+
+void device_close(device_t *d) {
+    device_detach(d);
+    for (int axis = 0; axis < 2; axis++)
+        evloop_timer_close(d->loop, &d->release[axis]);
+}
+
+int device_open(const char *path) {
+    int fd = open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+    if (isatty(fd)) {
+        struct termios tio;
+        if (tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            cfsetspeed(&tio, B115200);
+            tio.c_cc[VMIN] = 1;
+            tio.c_cc[VTIME] = 0;
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+        tcflush(fd, TCIFLUSH);
+    }
+    return fd;
+}
+
+bool device_attach(device_t *d, int fd, const char *path) {
+    struct stat st;
+    device_detach(d);
+    snprintf(d->path, sizeof d->path, "%s", path);
+    d->tty.fd = fd;
+    parser_init(&d->parser);
+    d->attaches++;
+    if (d->shm) shm_export_attached(d->shm, true);
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) return true;
+    if (!evloop_add(d->loop, &d->tty, EPOLLIN)) {
+        d->tty.fd = -1;
+        close(fd);
+        return false;
+    }
+    return true;
+}
+
+void device_detach(device_t *d) {
+    if (!device_attached(d)) return;
+    evloop_del(d->loop, &d->tty);
+    close(d->tty.fd);
+    d->tty.fd = -1;
+    // Nothing may stay held while the controller is gone.
+    bridge_release_all(&d->bridge);
+    for (int axis = 0; axis < 2; axis++)
+        evloop_timer_disarm(&d->release[axis]);
+    if (d->shm) shm_export_attached(d->shm, false);
+}
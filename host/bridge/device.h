@@ -0,0 +1,70 @@
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bridge.h"
+#include "capture.h"
+#include "evloop.h"
+#include "parser.h"
+#include "shm_export.h"
+#include "sink.h"
+
+#define DEVICE_PATH_MAX 64
+
+// One controller: its tty, stream parser, key state and the release
+// timer of each direction axis. The device outlives its tty: when the
+// Pico resets, the tty is detached (every key it held is released) and
+// a new one attached later, with a fresh parser.
+typedef struct device device_t;
+
+typedef struct {
+    uint64_t frames;            // reads that carried data
+    uint64_t lat_sum_us;        // read returned -> frame's SYN_REPORT written
+    uint32_t lat_max_us;        // since the last stats line
+    uint32_t lat_peak_us;       // since start
+} device_stats_t;
+
+struct device {
+    evloop_t *loop;
+    char path[DEVICE_PATH_MAX];
+    evloop_watch_t tty;         // fd -1 while detached
+    parser_t parser;
+    bridge_t bridge;
+    evloop_timer_t release[2];
+    uint64_t t_us;              // arrival time of the read being parsed
+    uint32_t attaches;
+    char label[32];             // USB serial, or the tty name
+    sink_t *sink;
+    shm_export_t *shm;          // NULL unless the state is exported
+    capture_t *cap;             // NULL unless the stream is recorded
+    device_stats_t stats;
+    // Called from the loop on EOF or hangup, with the tty still attached.
+    void (*on_gone)(device_t *d);
+    void *owner;
+};
+
+bool device_init(device_t *d, evloop_t *loop, sink_t *sink);
+void device_close(device_t *d);
+
+// Opens a tty in raw mode (regular files as they are); -1 with errno set.
+int device_open(const char *path);
+
+// Takes ownership of fd. Regular files are not watched (epoll refuses
+// them); drain those with device_pump.
+bool device_attach(device_t *d, int fd, const char *path);
+void device_detach(device_t *d);
+
+static inline bool device_attached(const device_t *d) {
+    return d->tty.fd >= 0;
+}
+
+// One read from the tty into the bridge; false at EOF or on error.
+bool device_pump(device_t *d);
+
+// One record of a capture (capture.h) into the bridge, on the capture's
+// clock and as fast as it goes; false at the end or if corrupt.
+bool device_pump_capture(device_t *d, capture_reader_t *r);
+
+#endif // DEVICE_H
@@ -0,0 +1,106 @@
+#include "discover.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
+static bool read_attr(const char *dir, const char *attr, char *out, size_t size) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof path, "%s/%s", dir, attr);
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    bool ok = fgets(out, (int)size, f) != NULL;
+    fclose(f);
+    if (ok) out[strcspn(out, "\n")] = '\0';
+    return ok;
+}
+
+static bool is_serial_tty(const char *name) {
+    return !strncmp(name, "ttyACM", 6) || !strncmp(name, "ttyUSB", 6);
+}
+
+// The USB device directory (with idVendor, idProduct, serial) behind a
+// tty: device -> the USB interface (…/1-1:1.0), whose parent it is.
+static bool usb_dir(const char *name, char dir[PATH_MAX]) {
+    char link[PATH_MAX], vid[8];
+    if (!is_serial_tty(name)) return false;
+    snprintf(link, sizeof link, "/sys/class/tty/%s/device", name);
+    if (!realpath(link, dir)) return false;
+    for (int up = 0; up < 2; up++) {
+        if (read_attr(dir, "idVendor", vid, sizeof vid)) return true;
+        char *slash = strrchr(dir, '/');
+        if (!slash || slash == dir) return false;
+        *slash = '\0';
+    }
+    return false;
+}
+
+bool discover_match(const char *name, const discover_filter_t *f) {
+    char dir[PATH_MAX], buf[64];
+    if (!usb_dir(name, dir)) return false;
+    if (!read_attr(dir, "idVendor", buf, sizeof buf) || strtoul(buf, NULL, 16) != f->vid) return false;
+    if (!read_attr(dir, "idProduct", buf, sizeof buf) || strtoul(buf, NULL, 16) != f->pid) return false;
+    if (!f->serial) return true;
+    return read_attr(dir, "serial", buf, sizeof buf) && !strcasecmp(buf, f->serial);
+}
+
+bool discover_serial(const char *name, char *out, size_t size) {
+    char dir[PATH_MAX];
+    return usb_dir(name, dir) && read_attr(dir, "serial", out, size) && out[0];
+}
+
+int discover_scan(const discover_filter_t *f, char names[][DISCOVER_NAME_MAX], int max) {
+    DIR *d = opendir("/sys/class/tty");
+    if (!d) return 0;
+    int n = 0;
+    struct dirent *e;
+    while (n < max && (e = readdir(d)) != NULL) {
+        if (strlen(e->d_name) >= DISCOVER_NAME_MAX || !discover_match(e->d_name, f)) continue;
+        strcpy(names[n++], e->d_name);
+    }
+    closedir(d);
+    return n;
+}
+
+int hotplug_open(void) {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) return -1;
+    struct sockaddr_nl addr = { .nl_family = AF_NETLINK, .nl_pid = 0, .nl_groups = 1 };
+    if (bind(fd, (struct sockaddr *)&addr, sizeof addr) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Kernel uevent: "add@/devices/...\0ACTION=add\0SUBSYSTEM=tty\0DEVNAME=ttyACM0\0...".
+hotplug_action_t hotplug_read(int fd, char name[DISCOVER_NAME_MAX], bool *more) {
+    char buf[4096];
+    ssize_t len = recv(fd, buf, sizeof buf - 1, 0);
+    *more = len > 0 || (len < 0 && errno == EINTR);
+    if (len <= 0) return HOTPLUG_NONE;
+    buf[len] = '\0';
+
+    const char *action = NULL, *subsystem = NULL, *devname = NULL;
+    for (char *p = buf; p < buf + len; p += strlen(p) + 1) {
+        if (!strncmp(p, "ACTION=", 7)) action = p + 7;
+        else if (!strncmp(p, "SUBSYSTEM=", 10)) subsystem = p + 10;
+        else if (!strncmp(p, "DEVNAME=", 8)) devname = p + 8;
+    }
+    if (!action || !subsystem || !devname || strcmp(subsystem, "tty")) return HOTPLUG_NONE;
+
+    const char *base = strrchr(devname, '/');
+    base = base ? base + 1 : devname;
+    if (!is_serial_tty(base) || strlen(base) >= DISCOVER_NAME_MAX) return HOTPLUG_NONE;
+    strcpy(name, base);
+    if (!strcmp(action, "add")) return HOTPLUG_ADD;
+    if (!strcmp(action, "remove")) return HOTPLUG_REMOVE;
+    return HOTPLUG_NONE;
+}
@@ -0,0 +1,46 @@
+#ifndef DISCOVER_H
+#define DISCOVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Finds the controller by its USB identity instead of opening every tty:
+// only /sys/class/tty/tty{ACM,USB}* are looked at, and only their sysfs
+// attributes are read. Hotplug comes from the kernel's uevent netlink
+// socket, so no libudev is needed.
+
+// Pico SDK stdio_usb defaults; the firmware sends over stdio_usb
+// (main/CMakeLists.txt).
+#define DISCOVER_PICO_VID  0x2e8a
+#define DISCOVER_PICO_PID  0x000a
+
+typedef struct {
+    uint16_t vid, pid;
+    const char *serial;     // NULL matches any board
+} discover_filter_t;
+
+#define DISCOVER_NAME_MAX 32
+
+// True if /dev/<name> belongs to a USB device matching f.
+bool discover_match(const char *name, const discover_filter_t *f);
+
+// USB serial number of the device behind /dev/<name>; false if it has
+// none or is not USB. Stable across resets, unlike the tty name.
+bool discover_serial(const char *name, char *out, size_t size);
+
+// Fills names with up to max matching tty names (e.g. "ttyACM0");
+// returns how many matched.
+int discover_scan(const discover_filter_t *f, char names[][DISCOVER_NAME_MAX], int max);
+
+typedef enum { HOTPLUG_NONE, HOTPLUG_ADD, HOTPLUG_REMOVE } hotplug_action_t;
+
+// Non-blocking netlink socket receiving kernel uevents; -1 on error.
+int hotplug_open(void);
+
+// Reads one uevent. Returns HOTPLUG_ADD/REMOVE with name set for tty
+// devices, HOTPLUG_NONE for anything else or when nothing is pending
+// (*more is false then).
+hotplug_action_t hotplug_read(int fd, char name[DISCOVER_NAME_MAX], bool *more);
+
+#endif // DISCOVER_H
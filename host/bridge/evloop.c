@@ -0,0 +1,138 @@
+#include "evloop.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+#define EVLOOP_BATCH 64
+
+uint64_t evloop_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+}
+
+static void on_signal(void *ctx, uint32_t events) {
+    evloop_t *l = ctx;
+    struct signalfd_siginfo si;
+    (void)events;
+    while (read(l->sig.fd, &si, sizeof si) == (ssize_t)sizeof si)
+        ;
+    evloop_stop(l);
+}
+
+bool evloop_init(evloop_t *l) {
+    memset(l, 0, sizeof *l);
+    l->sig.fd = -1;
+    l->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (l->epfd < 0) {
+        perror("epoll_create1");
+        return false;
+    }
+
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGTERM);
+    sigprocmask(SIG_BLOCK, &set, NULL);
+    l->sig.fd = signalfd(-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+    l->sig.cb = on_signal;
+    l->sig.ctx = l;
+    if (l->sig.fd < 0 || !evloop_add(l, &l->sig, EPOLLIN)) {
+        perror("signalfd");
+        evloop_close(l);
+        return false;
+    }
+    return true;
+}
+
+void evloop_close(evloop_t *l) {
+    if (l->sig.fd >= 0) close(l->sig.fd);
+    if (l->epfd >= 0) close(l->epfd);
+    l->sig.fd = l->epfd = -1;
+}
+
+bool evloop_add(evloop_t *l, evloop_watch_t *w, uint32_t events) {
+    struct epoll_event ev = { .events = events, .data.ptr = w };
+    return epoll_ctl(l->epfd, EPOLL_CTL_ADD, w->fd, &ev) == 0;
+}
+
+void evloop_del(evloop_t *l, evloop_watch_t *w) {
+    epoll_ctl(l->epfd, EPOLL_CTL_DEL, w->fd, NULL);
+}
+
+static void on_timer(void *ctx, uint32_t events) {
+    evloop_timer_t *t = ctx;
+    uint64_t expirations;
+    (void)events;
+    // A re-arm between the expiry and this read leaves nothing to read.
+    if (read(t->w.fd, &expirations, sizeof expirations) != (ssize_t)sizeof expirations)
+        return;
+    t->deadline_us = 0;
+    t->cb(t->ctx, events);
+}
+
+bool evloop_timer_init(evloop_t *l, evloop_timer_t *t, evloop_cb_t cb, void *ctx) {
+    memset(t, 0, sizeof *t);
+    t->cb = cb;
+    t->ctx = ctx;
+    t->w.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    t->w.cb = on_timer;
+    t->w.ctx = t;
+    if (t->w.fd < 0 || !evloop_add(l, &t->w, EPOLLIN)) {
+        perror("timerfd");
+        if (t->w.fd >= 0) close(t->w.fd);
+        t->w.fd = -1;
+        return false;
+    }
+    return true;
+}
+
+void evloop_timer_close(evloop_t *l, evloop_timer_t *t) {
+    if (t->w.fd < 0) return;
+    evloop_del(l, &t->w);
+    close(t->w.fd);
+    t->w.fd = -1;
+}
+
+void evloop_timer_arm(evloop_timer_t *t, uint64_t deadline_us) {
+    if (!deadline_us) deadline_us = 1;   // it_value 0 would disarm
+    struct itimerspec its = {
+        .it_value = { .tv_sec = deadline_us / 1000000u,
+                      .tv_nsec = (deadline_us % 1000000u) * 1000 },
+    };
+    t->deadline_us = deadline_us;
+    timerfd_settime(t->w.fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+void evloop_timer_disarm(evloop_timer_t *t) {
+    struct itimerspec its = { { 0, 0 }, { 0, 0 } };
+    t->deadline_us = 0;
+    timerfd_settime(t->w.fd, 0, &its, NULL);
+}
+
+void evloop_run(evloop_t *l) {
+    struct epoll_event evs[EVLOOP_BATCH];
+    while (!l->stop) {
+        int n = epoll_wait(l->epfd, evs, EVLOOP_BATCH, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n && !l->stop; i++) {
+            evloop_watch_t *w = evs[i].data.ptr;
+            w->cb(w->ctx, evs[i].events);
+        }
+    }
+}
+
+void evloop_stop(evloop_t *l) {
+    l->stop = true;
+}
@@ -0,0 +1,52 @@
+#ifndef EVLOOP_H
+#define EVLOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Minimal epoll loop: file descriptors, absolute-deadline timers
+// (timerfd, CLOCK_MONOTONIC) and SIGINT/SIGTERM (signalfd). The loop
+// sleeps in epoll_wait until one of them is ready; nothing polls.
+typedef void (*evloop_cb_t)(void *ctx, uint32_t events);
+
+typedef struct {
+    int fd;
+    evloop_cb_t cb;
+    void *ctx;
+} evloop_watch_t;
+
+typedef struct {
+    int epfd;
+    bool stop;
+    evloop_watch_t sig;
+} evloop_t;
+
+typedef struct {
+    evloop_watch_t w;       // the timerfd
+    evloop_cb_t cb;
+    void *ctx;
+    uint64_t deadline_us;   // 0 = disarmed
+} evloop_timer_t;
+
+// CLOCK_MONOTONIC in µs; the time base of every deadline below.
+uint64_t evloop_now_us(void);
+
+// Also blocks SIGINT/SIGTERM and turns them into evloop_stop().
+bool evloop_init(evloop_t *l);
+void evloop_close(evloop_t *l);
+
+// w->fd, w->cb and w->ctx must be set; w must stay alive while watched.
+bool evloop_add(evloop_t *l, evloop_watch_t *w, uint32_t events);
+void evloop_del(evloop_t *l, evloop_watch_t *w);
+
+// cb runs once per expiry, after the timer is disarmed.
+bool evloop_timer_init(evloop_t *l, evloop_timer_t *t, evloop_cb_t cb, void *ctx);
+void evloop_timer_close(evloop_t *l, evloop_timer_t *t);
+void evloop_timer_arm(evloop_timer_t *t, uint64_t deadline_us);
+void evloop_timer_disarm(evloop_timer_t *t);
+
+// Dispatches until evloop_stop() or a signal.
+void evloop_run(evloop_t *l);
+void evloop_stop(evloop_t *l);
+
+#endif // EVLOOP_H
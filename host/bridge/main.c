@@ -0,0 +1,382 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+
+#include "bridge.h"
+#include "device.h"
+#include "discover.h"
+#include "evloop.h"
+#include "sink.h"
+
+// bridge [--all] [--shm] [--capture path] [--vid 2e8a] [--pid 000a] [--serial <id>] [--sink ...] [--stats s]
+// bridge --in <tty|capture|dump> [--in ...] [--shm] [--capture path] [--sink uinput|file:<path>|null] [--stats s]
+//
+// Native replacement for main/main.py: reads the controllers' packets
+// and injects them as virtual mice + keyboards through /dev/uinput. The
+// user running it needs write access to /dev/uinput (e.g. a udev rule
+// giving it to the input group).
+//
+// Without --in controllers are found by USB VID/PID (and serial number,
+// to pick one board among several) and followed across resets and
+// replugs: the kernel's uevent for the new tty triggers the reattach.
+// --all bridges every matching board at once.
+//
+// Each controller has its own parser, key state and sink (one uinput
+// device each, or file:out-%s.txt), all on one thread and one epoll set.
+// --stats prints per-device and total telemetry every s seconds. --shm
+// publishes each controller's live state for other local programs
+// (ctlstate.h). --capture out-%s.pecap records each raw stream with its
+// receive times for the replay tool (capture.h).
+
+#define MAX_DEVICES       64
+
+// udev may still be applying the tty's group when the kernel's add event
+// arrives; opening is retried this often, this many times.
+#define REOPEN_RETRY_US   5000u
+#define REOPEN_RETRIES    400
+
+typedef struct {
+    uint64_t bytes, packets, frames, lat_sum_us;
+} snapshot_t;
+
+typedef struct {
+    evloop_t loop;
+    device_t *devs[MAX_DEVICES];
+    snapshot_t last[MAX_DEVICES];   // counters at the previous stats line
+    int ndevs;
+    const char *sink_spec;
+    discover_filter_t filter;
+    bool follow;                    // discovery mode: survive hangups
+    bool all;
+    bool shm;                       // export state in /pico_emb.<label>
+    const char *capture;            // record each stream (path, %s = label)
+    evloop_watch_t hotplug;
+    evloop_timer_t retry;
+    int retries;
+    evloop_timer_t stats;
+    uint64_t stats_us, stats_at;
+} app_t;
+
+static void on_gone(device_t *d);
+
+static device_t *new_device(app_t *a, const char *label) {
+    if (a->ndevs == MAX_DEVICES) {
+        fprintf(stderr, "%s: more than %d devices\n", label, MAX_DEVICES);
+        return NULL;
+    }
+    device_t *d = malloc(sizeof *d);
+    sink_t *sink = sink_open(a->sink_spec, label);
+    if (!d || !sink || !device_init(d, &a->loop, sink)) {
+        if (sink) sink_close(sink);
+        free(d);
+        return NULL;
+    }
+    snprintf(d->label, sizeof d->label, "%s", label);
+    if (a->shm && !(d->shm = shm_export_open(label))) {
+        device_close(d);
+        sink_close(sink);
+        free(d);
+        return NULL;
+    }
+    if (a->capture) {
+        char path[256];
+        const char *mark = strstr(a->capture, "%s");
+        if (mark)
+            snprintf(path, sizeof path, "%.*s%s%s", (int)(mark - a->capture), a->capture, label, mark + 2);
+        else
+            snprintf(path, sizeof path, "%s", a->capture);
+        d->cap = malloc(sizeof *d->cap);
+        if (!d->cap || !capture_open(d->cap, path, label, evloop_now_us())) {
+            fprintf(stderr, "%s: cannot record\n", path);
+            free(d->cap);
+            d->cap = NULL;
+        }
+    }
+    d->on_gone = on_gone;
+    d->owner = a;
+    a->devs[a->ndevs++] = d;
+    return d;
+}
+
+static device_t *find_path(app_t *a, const char *path) {
+    for (int i = 0; i < a->ndevs; i++)
+        if (device_attached(a->devs[i]) && !strcmp(a->devs[i]->path, path)) return a->devs[i];
+    return NULL;
+}
+
+// The device a board reattaches to: same USB serial (or, without one,
+// same tty name), so its sink and uinput device survive the reset.
+static device_t *find_label(app_t *a, const char *label) {
+    for (int i = 0; i < a->ndevs; i++)
+        if (!strcmp(a->devs[i]->label, label)) return a->devs[i];
+    return NULL;
+}
+
+static int attached_count(const app_t *a) {
+    int n = 0;
+    for (int i = 0; i < a->ndevs; i++) n += device_attached(a->devs[i]);
+    return n;
+}
+
+// Opens /dev/<name> and attaches it; false if it should be retried.
+static bool try_attach(app_t *a, const char *name) {
+    char path[DEVICE_PATH_MAX], label[32];
+    snprintf(path, sizeof path, "/dev/%s", name);
+    if (find_path(a, path)) return true;
+    if (!discover_serial(name, label, sizeof label)) snprintf(label, sizeof label, "%s", name);
+
+    device_t *d = find_label(a, label);
+    if (d && device_attached(d)) return true;
+    if (!d && !a->all && a->ndevs) {
+        // Single-controller mode: a new board takes over the one device.
+        // It keeps the first board's label, which names its sink, shm
+        // segment and capture file.
+        d = a->devs[0];
+        if (device_attached(d)) return true;
+    }
+
+    int fd = device_open(path);
+    if (fd < 0) {
+        if (errno == EACCES || errno == ENOENT || errno == EBUSY) return false;
+        perror(path);
+        return true;
+    }
+    if (!d && !(d = new_device(a, label))) {
+        close(fd);
+        return true;
+    }
+    if (device_attach(d, fd, path)) {
+        if (strcmp(d->label, label))
+            fprintf(stderr, "attached %s (%s, as %s)\n", path, label, d->label);
+        else
+            fprintf(stderr, "attached %s (%s)\n", path, d->label);
+    }
+    return true;
+}
+
+// Attaches every matching tty not attached yet (only the first one
+// without --all); retries the ones that could not be opened.
+static void scan(app_t *a) {
+    char names[MAX_DEVICES][DISCOVER_NAME_MAX];
+    int n = discover_scan(&a->filter, names, MAX_DEVICES);
+    bool again = false;
+    for (int i = 0; i < n; i++) {
+        if (!a->all && attached_count(a)) break;
+        again |= !try_attach(a, names[i]);
+    }
+    if (again && ++a->retries < REOPEN_RETRIES)
+        evloop_timer_arm(&a->retry, evloop_now_us() + REOPEN_RETRY_US);
+}
+
+static void on_retry(void *ctx, uint32_t events) {
+    (void)events;
+    scan(ctx);
+}
+
+static void on_hotplug(void *ctx, uint32_t events) {
+    app_t *a = ctx;
+    char name[DISCOVER_NAME_MAX], path[DEVICE_PATH_MAX];
+    bool more = true, added = false;
+    (void)events;
+    while (more) {
+        hotplug_action_t act = hotplug_read(a->hotplug.fd, name, &more);
+        if (act == HOTPLUG_ADD) {
+            added = true;
+        } else if (act == HOTPLUG_REMOVE) {
+            snprintf(path, sizeof path, "/dev/%s", name);
+            device_t *d = find_path(a, path);
+            if (d) {
+                fprintf(stderr, "removed %s (%s)\n", path, d->label);
+                device_detach(d);
+            }
+        }
+    }
+    if (added) {
+        a->retries = 0;
+        scan(a);
+    }
+}
+
+static void on_gone(device_t *d) {
+    app_t *a = d->owner;
+    if (!a->follow) {
+        device_detach(d);
+        if (!attached_count(a)) evloop_stop(&a->loop);
+        return;
+    }
+    // The hangup comes just before the remove uevent; the add of the
+    // re-enumerated board brings the device back.
+    fprintf(stderr, "lost %s (%s)\n", d->path, d->label);
+    device_detach(d);
+}
+
+static void print_stats(app_t *a, bool final) {
+    uint64_t now = evloop_now_us();
+    double secs = final ? 0 : (now - a->stats_at) / 1e6;
+    snapshot_t total = { 0 };
+    uint64_t garbage = 0, resyncs = 0, sink_errors = 0;
+    uint32_t lat_max = 0;
+    for (int i = 0; i < a->ndevs; i++) {
+        device_t *d = a->devs[i];
+        snapshot_t now_s = { d->parser.stats.bytes, d->bridge.stats.packets,
+                             d->stats.frames, d->stats.lat_sum_us };
+        snapshot_t *prev = final ? &(snapshot_t){ 0 } : &a->last[i];
+        snapshot_t w = { now_s.bytes - prev->bytes, now_s.packets - prev->packets,
+                         now_s.frames - prev->frames, now_s.lat_sum_us - prev->lat_sum_us };
+        uint32_t lat = final ? d->stats.lat_peak_us : d->stats.lat_max_us;
+        fprintf(stderr, "dev=%s up=%d", d->label, device_attached(d));
+        if (secs > 0)
+            fprintf(stderr, " pkt_per_s=%.1f frames_per_s=%.1f", w.packets / secs, w.frames / secs);
+        else
+            fprintf(stderr, " bytes=%llu packets=%llu frames=%llu", (unsigned long long)w.bytes,
+                    (unsigned long long)w.packets, (unsigned long long)w.frames);
+        fprintf(stderr, " garbage=%llu resyncs=%llu sink_errors=%u attaches=%u lat_mean_us=%.1f lat_max_us=%u\n",
+                (unsigned long long)d->parser.stats.garbage, (unsigned long long)d->parser.stats.resyncs,
+                d->bridge.stats.sink_errors, d->attaches,
+                w.frames ? (double)w.lat_sum_us / w.frames : 0.0, lat);
+        total.bytes += w.bytes;
+        total.packets += w.packets;
+        total.frames += w.frames;
+        total.lat_sum_us += w.lat_sum_us;
+        garbage += d->parser.stats.garbage;
+        resyncs += d->parser.stats.resyncs;
+        sink_errors += d->bridge.stats.sink_errors;
+        if (lat > lat_max) lat_max = lat;
+        a->last[i] = now_s;
+        if (!final) d->stats.lat_max_us = 0;    // max per window
+    }
+    fprintf(stderr, "total devices=%d up=%d", a->ndevs, attached_count(a));
+    if (secs > 0)
+        fprintf(stderr, " pkt_per_s=%.1f frames_per_s=%.1f", total.packets / secs, total.frames / secs);
+    else
+        fprintf(stderr, " packets=%llu frames=%llu", (unsigned long long)total.packets,
+                (unsigned long long)total.frames);
+    fprintf(stderr, " garbage=%llu resyncs=%llu sink_errors=%llu lat_mean_us=%.1f lat_max_us=%u\n",
+            (unsigned long long)garbage, (unsigned long long)resyncs, (unsigned long long)sink_errors,
+            total.frames ? (double)total.lat_sum_us / total.frames : 0.0, lat_max);
+    a->stats_at = now;
+}
+
+static void on_stats(void *ctx, uint32_t events) {
+    app_t *a = ctx;
+    (void)events;
+    print_stats(a, false);
+    evloop_timer_arm(&a->stats, a->stats_at + a->stats_us);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--all] [--shm] [--capture path] [--vid hex] [--pid hex] [--serial id] [--sink uinput|file:<path>|null] [--stats s]\n"
+            "       %s --in <tty|capture|dump> [--in ...] [--shm] [--capture path] [--sink ...] [--stats s]\n",
+            argv0, argv0);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    static app_t app;
+    const char *ins[MAX_DEVICES];
+    int nins = 0;
+    app.sink_spec = "uinput";
+    app.filter.vid = DISCOVER_PICO_VID;
+    app.filter.pid = DISCOVER_PICO_PID;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--in") && i + 1 < argc && nins < MAX_DEVICES)
+            ins[nins++] = argv[++i];
+        else if (!strcmp(argv[i], "--sink") && i + 1 < argc)
+            app.sink_spec = argv[++i];
+        else if (!strcmp(argv[i], "--vid") && i + 1 < argc)
+            app.filter.vid = (uint16_t)strtoul(argv[++i], NULL, 16);
+        else if (!strcmp(argv[i], "--pid") && i + 1 < argc)
+            app.filter.pid = (uint16_t)strtoul(argv[++i], NULL, 16);
+        else if (!strcmp(argv[i], "--serial") && i + 1 < argc)
+            app.filter.serial = argv[++i];
+        else if (!strcmp(argv[i], "--all"))
+            app.all = true;
+        else if (!strcmp(argv[i], "--shm"))
+            app.shm = true;
+        else if (!strcmp(argv[i], "--capture") && i + 1 < argc)
+            app.capture = argv[++i];
+        else if (!strcmp(argv[i], "--stats") && i + 1 < argc)
+            app.stats_us = (uint64_t)(atof(argv[++i]) * 1e6);
+        else
+            usage(argv[0]);
+    }
+    app.follow = !nins;
+    if (!evloop_init(&app.loop)) return 1;
+
+    bool live = false;
+    for (int i = 0; i < nins; i++) {
+        const char *base = strrchr(ins[i], '/');
+        device_t *d = new_device(&app, base ? base + 1 : ins[i]);
+        int fd = device_open(ins[i]);
+        if (!d || fd < 0 || !device_attach(d, fd, ins[i])) {
+            perror(ins[i]);
+            return 1;
+        }
+        // epoll does not take regular files: they are read straight
+        // through. A capture (bridge --capture) gives one frame per
+        // record; anything else is a raw byte dump, one frame per read.
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            capture_reader_t r;
+            if (capture_reader_open(&r, ins[i])) {
+                while (device_pump_capture(d, &r))
+                    ;
+                capture_reader_close(&r);
+            } else {
+                while (device_pump(d))
+                    ;
+            }
+            device_detach(d);
+        } else {
+            live = true;
+        }
+    }
+
+    if (app.follow) {
+        live = true;
+        app.hotplug.fd = hotplug_open();
+        app.hotplug.cb = on_hotplug;
+        app.hotplug.ctx = &app;
+        if (app.hotplug.fd < 0 || !evloop_add(&app.loop, &app.hotplug, EPOLLIN)) {
+            perror("uevent socket");
+            return 1;
+        }
+        if (!evloop_timer_init(&app.loop, &app.retry, on_retry, &app)) return 1;
+        scan(&app);
+        if (!attached_count(&app))
+            fprintf(stderr, "waiting for %04x:%04x%s%s\n", app.filter.vid, app.filter.pid,
+                    app.filter.serial ? " serial " : "", app.filter.serial ? app.filter.serial : "");
+    }
+
+    if (live) {
+        app.stats_at = evloop_now_us();
+        if (app.stats_us) {
+            if (!evloop_timer_init(&app.loop, &app.stats, on_stats, &app)) return 1;
+            evloop_timer_arm(&app.stats, app.stats_at + app.stats_us);
+        }
+        evloop_run(&app.loop);
+    }
+
+    for (int i = 0; i < app.ndevs; i++)
+        device_close(app.devs[i]);
+    print_stats(&app, true);
+    for (int i = 0; i < app.ndevs; i++) {
+        sink_close(app.devs[i]->sink);
+        shm_export_close(app.devs[i]->shm);
+        if (app.devs[i]->cap) {
+            fprintf(stderr, "captured %s: records=%llu bytes=%llu\n", app.devs[i]->label,
+                    (unsigned long long)app.devs[i]->cap->records,
+                    (unsigned long long)app.devs[i]->cap->bytes);
+            capture_close(app.devs[i]->cap);
+            free(app.devs[i]->cap);
+        }
+        free(app.devs[i]);
+    }
+    evloop_close(&app.loop);
+    return 0;
+}
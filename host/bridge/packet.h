@@ -0,0 +1,25 @@
+#ifndef PACKET_H
+#define PACKET_H
+
+#include <stdint.h>
+
+// Controller packets (main.c, enviar_*):
+//   A0 axis msb lsb FF   axis 0 = X, 1 = Y: signed 16-bit mouse delta
+//   B0 code state FE     button code (' ', 'R', 'E', 1 = right click,
+//                        2 = shift), state 1 = pressed
+//   C0 axis cmd CF       WASD: axis 0 = horizontal, 1 = vertical,
+//                        repeated every 50 ms while the stick is held
+#define PKT_AXIS_HDR     0xA0
+#define PKT_AXIS_FTR     0xFF
+#define PKT_BUTTON_HDR   0xB0
+#define PKT_BUTTON_FTR   0xFE
+#define PKT_DIR_HDR      0xC0
+#define PKT_DIR_FTR      0xCF
+
+typedef struct {
+    uint8_t hdr;
+    uint8_t id;        // axis or button code
+    int16_t val;       // delta, button state or direction letter
+} packet_t;
+
+#endif // PACKET_H
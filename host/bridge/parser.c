@@ -0,0 +1,87 @@
+#include "parser.h"
+
+#include <string.h>
+
+void parser_init(parser_t *ps) {
+    memset(ps, 0, sizeof *ps);
+}
+
+// Body length after the header, footer included; 0 if c is no header.
+static uint8_t body_len(uint8_t c) {
+    switch (c) {
+    case PKT_AXIS_HDR:   return 4;
+    case PKT_BUTTON_HDR: return 3;
+    case PKT_DIR_HDR:    return 3;
+    default:             return 0;
+    }
+}
+
+static uint8_t footer(uint8_t hdr) {
+    switch (hdr) {
+    case PKT_AXIS_HDR:   return PKT_AXIS_FTR;
+    case PKT_BUTTON_HDR: return PKT_BUTTON_FTR;
+    default:             return PKT_DIR_FTR;
+    }
+}
+
+static size_t step(parser_t *ps, uint8_t c, parser_cb_t cb, void *ctx) {
+    if (!ps->hdr) {
+        ps->need = body_len(c);
+        if (ps->need) {
+            ps->hdr = c;
+            ps->n = 0;
+        } else {
+            ps->stats.garbage++;
+        }
+        return 0;
+    }
+
+    ps->body[ps->n++] = c;
+    if (ps->n < ps->need) return 0;
+
+    if (c == footer(ps->hdr)) {
+        packet_t p = { .hdr = ps->hdr, .id = ps->body[0] };
+        if (ps->hdr == PKT_AXIS_HDR)
+            p.val = (int16_t)((ps->body[1] << 8) | ps->body[2]);
+        else
+            p.val = ps->body[1];
+        ps->hdr = 0;
+        ps->stats.packets++;
+        cb(ctx, &p);
+        return 1;
+    }
+
+    // Drop the false header and rescan what followed it. Each level
+    // starts one byte later, so this nests at most body-length deep.
+    uint8_t replay[sizeof ps->body];
+    uint8_t n = ps->n;
+    memcpy(replay, ps->body, n);
+    ps->hdr = 0;
+    ps->stats.garbage++;
+    ps->stats.resyncs++;
+    size_t got = 0;
+    for (uint8_t i = 0; i < n; i++)
+        got += step(ps, replay[i], cb, ctx);
+    return got;
+}
+
+size_t parser_feed(parser_t *ps, const uint8_t *buf, size_t len,
+                   parser_cb_t cb, void *ctx) {
+    size_t got = 0;
+    ps->stats.bytes += len;
+    for (size_t i = 0; i < len; i++) {
+        // Fast path: a complete packet at the start of the remaining
+        // bytes, which is what a clean stream always has.
+        if (!ps->hdr && len - i >= 5 && buf[i] == PKT_AXIS_HDR && buf[i + 4] == PKT_AXIS_FTR) {
+            packet_t p = { .hdr = PKT_AXIS_HDR, .id = buf[i + 1],
+                           .val = (int16_t)((buf[i + 2] << 8) | buf[i + 3]) };
+            ps->stats.packets++;
+            cb(ctx, &p);
+            got++;
+            i += 4;
+            continue;
+        }
+        got += step(ps, buf[i], cb, ctx);
+    }
+    return got;
+}
@@ -0,0 +1,40 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "packet.h"
+
+// Streaming decoder for the controller's byte stream. Feed it whatever
+// one read() returned; packets split across reads are carried over.
+//
+// Any byte seen while waiting for a header that is not A0/B0/C0 is
+// garbage. When a body ends in the wrong footer the header was a data
+// byte (msb/lsb can be 0xA0..0xC0), so only the header is dropped and
+// the body bytes are scanned again for the real start of a packet: a
+// single lost byte costs at most one packet, never a run of them.
+typedef struct {
+    uint64_t bytes;
+    uint64_t packets;
+    uint64_t garbage;      // bytes dropped while looking for a header
+    uint64_t resyncs;      // bodies rejected for a bad footer
+} parser_stats_t;
+
+typedef void (*parser_cb_t)(void *ctx, const packet_t *p);
+
+typedef struct {
+    uint8_t hdr;           // 0 while looking for a header
+    uint8_t need, n;       // body length (footer included) / bytes so far
+    uint8_t body[4];
+    parser_stats_t stats;
+} parser_t;
+
+void parser_init(parser_t *ps);
+
+// Runs the state machine over buf and calls cb for each packet; returns
+// the number of packets.
+size_t parser_feed(parser_t *ps, const uint8_t *buf, size_t len,
+                   parser_cb_t cb, void *ctx);
+
+#endif // PARSER_H
@@ -0,0 +1,190 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "capture.h"
+#include "parser.h"
+
+// parser_bench capture.pecap [...]  throughput on recorded streams
+//                                   (bridge --capture, or raw dumps)
+// parser_bench --gen out.bin [N]    writes a synthetic capture
+//
+// One result line per capture and mode (key=value):
+//   bulk      4 KB read()s from the file into the streaming parser
+//   perpkt    main.py's loop: read(1) for the header, then the body
+//   parse     the state machine alone, on the capture held in memory
+// The file reads hit the page cache, so bulk vs perpkt is mostly the
+// syscall count; on a tty each of those reads is also a wake-up.
+
+#define BENCH_MIN_NS  500000000ull
+#define READ_SIZE     4096
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void count(void *ctx, const packet_t *p) {
+    (void)p;
+    (*(uint64_t *)ctx)++;
+}
+
+// Streams as the firmware writes them: mostly axis packets, some WASD and
+// buttons, deltas that hit header values, and an occasional stray byte.
+static int gen(const char *path, long packets) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    srand(1);
+    for (long i = 0; i < packets; i++) {
+        int r = rand() % 100;
+        if (r < 75) {
+            int16_t v = (int16_t)(rand() % 2 ? rand() % 400 - 200 : 0xA0C0);
+            uint8_t pkt[5] = { PKT_AXIS_HDR, (uint8_t)(rand() % 2), (uint8_t)(v >> 8), (uint8_t)v, PKT_AXIS_FTR };
+            fwrite(pkt, 1, 5, f);
+        } else if (r < 90) {
+            uint8_t pkt[4] = { PKT_DIR_HDR, (uint8_t)(rand() % 2), rand() % 2 ? 'A' : 'S', PKT_DIR_FTR };
+            fwrite(pkt, 1, 4, f);
+        } else if (r < 99) {
+            static const uint8_t codes[] = { ' ', 'R', 'E', 1, 2 };
+            uint8_t pkt[4] = { PKT_BUTTON_HDR, codes[rand() % 5], (uint8_t)(rand() % 2), PKT_BUTTON_FTR };
+            fwrite(pkt, 1, 4, f);
+        } else {
+            fputc(rand() % 2 ? PKT_AXIS_HDR : 0x55, f);
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+// A bridge --capture recording is flattened to its bytes; anything else
+// is taken as a raw dump of the stream.
+static uint8_t *load(const char *path, size_t *len) {
+    capture_reader_t r;
+    if (capture_reader_open(&r, path)) {
+        static uint8_t rec[CAPTURE_MAX_READ];
+        uint8_t *buf = NULL;
+        uint64_t t;
+        long n;
+        *len = 0;
+        while ((n = capture_next(&r, &t, rec)) > 0) {
+            uint8_t *grown = realloc(buf, *len + (size_t)n);
+            if (!grown) break;
+            buf = grown;
+            memcpy(buf + *len, rec, (size_t)n);
+            *len += (size_t)n;
+        }
+        capture_reader_close(&r);
+        return buf ? buf : malloc(1);
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *len = (size_t)ftell(f);
+    rewind(f);
+    uint8_t *buf = malloc(*len ? *len : 1);
+    if (buf && fread(buf, 1, *len, f) != *len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    return buf;
+}
+
+static void report(const char *path, const char *mode, size_t len, uint64_t packets,
+                   const parser_stats_t *st, int reps, uint64_t ns) {
+    double per_rep = (double)ns / reps;
+    printf("parser_bench file=%s mode=%s bytes=%zu packets=%llu",
+           path, mode, len, (unsigned long long)packets);
+    if (st)
+        printf(" garbage=%llu resyncs=%llu",
+               (unsigned long long)st->garbage, (unsigned long long)st->resyncs);
+    printf(" MB_per_s=%.1f ns_per_packet=%.1f\n",
+           len / per_rep * 1000.0, packets ? per_rep / packets : 0.0);
+}
+
+static void bench_parse(const char *path, const uint8_t *buf, size_t len) {
+    parser_t ps;
+    uint64_t packets = 0, t0 = now_ns(), dt;
+    int reps = 0;
+    do {
+        parser_init(&ps);
+        packets = 0;
+        parser_feed(&ps, buf, len, count, &packets);
+        reps++;
+    } while ((dt = now_ns() - t0) < BENCH_MIN_NS);
+    report(path, "parse", len, packets, &ps.stats, reps, dt);
+}
+
+static void bench_bulk(const char *path, int fd, size_t len) {
+    static uint8_t buf[READ_SIZE];
+    parser_t ps;
+    uint64_t packets = 0, t0 = now_ns(), dt;
+    int reps = 0;
+    do {
+        lseek(fd, 0, SEEK_SET);
+        parser_init(&ps);
+        packets = 0;
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof buf)) > 0)
+            parser_feed(&ps, buf, (size_t)n, count, &packets);
+        reps++;
+    } while ((dt = now_ns() - t0) < BENCH_MIN_NS);
+    report(path, "bulk", len, packets, &ps.stats, reps, dt);
+}
+
+static void bench_perpkt(const char *path, int fd, size_t len) {
+    uint64_t packets = 0, t0 = now_ns(), dt;
+    int reps = 0;
+    do {
+        lseek(fd, 0, SEEK_SET);
+        packets = 0;
+        uint8_t hdr, body[4];
+        while (read(fd, &hdr, 1) == 1) {
+            size_t n = hdr == PKT_AXIS_HDR ? 4 : (hdr == PKT_BUTTON_HDR || hdr == PKT_DIR_HDR) ? 3 : 0;
+            if (!n) continue;
+            if (read(fd, body, n) != (ssize_t)n) break;
+            uint8_t ftr = hdr == PKT_AXIS_HDR ? PKT_AXIS_FTR : hdr == PKT_BUTTON_HDR ? PKT_BUTTON_FTR : PKT_DIR_FTR;
+            if (body[n - 1] == ftr) packets++;
+        }
+        reps++;
+    } while ((dt = now_ns() - t0) < BENCH_MIN_NS);
+    report(path, "perpkt", len, packets, NULL, reps, dt);
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 3 && !strcmp(argv[1], "--gen"))
+        return gen(argv[2], argc > 3 ? atol(argv[3]) : 200000);
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s capture.pecap|dump.bin [...] | --gen out.bin [packets]\n", argv[0]);
+        return 2;
+    }
+    for (int i = 1; i < argc; i++) {
+        size_t len;
+        uint8_t *buf = load(argv[i], &len);
+        if (!buf) return 1;
+        // The read modes go through a file of the bare stream, so a
+        // capture's record headers are not fed to them.
+        FILE *tmp = tmpfile();
+        if (!tmp || fwrite(buf, 1, len, tmp) != len || fflush(tmp)) return 1;
+        int fd = dup(fileno(tmp));
+        fclose(tmp);
+        if (fd < 0) return 1;
+        bench_parse(argv[i], buf, len);
+        bench_bulk(argv[i], fd, len);
+        bench_perpkt(argv[i], fd, len);
+        close(fd);
+        free(buf);
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bridge.h"
+#include "capture.h"
+#include "parser.h"
+#include "sink.h"
+
+// replay capture.pecap [--speed X | --fast] [--sink null|file:<path>|uinput]
+//
+// Feeds a `bridge --capture` recording back through the parser and the
+// output pipeline, one record (one original read) at a time:
+//   parse   parser_feed over the record's bytes
+//   map     bridge_packet for each packet (key state, deltas)
+//   inject  the WASD releases due, then bridge_flush into the sink
+// Key release deadlines follow the capture's clock, so the events a sink
+// receives do not depend on the replay speed.
+//
+// --speed 1 (the default) keeps the original timing, --speed 4 runs 4x
+// faster, --fast does not wait at all. Output: one summary line, then
+// one "kbench port=replay test=<stage>" line per stage with the mean
+// ns per record, which tools/kbench_compare.py diffs against a baseline
+// (the regression check), then p50/p99/max per stage and, for timed
+// replays, how late each record was fed compared with its schedule.
+
+#define MAX_PACKETS CAPTURE_MAX_READ
+
+enum { ST_PARSE, ST_MAP, ST_INJECT, ST_TOTAL, ST_LATE, ST_COUNT };
+static const char *const stage_names[ST_COUNT] = { "parse", "map", "inject", "total", "late" };
+
+typedef struct {
+    uint32_t *v;
+    size_t n, cap;
+    uint64_t sum;
+} series_t;
+
+typedef struct {
+    packet_t pkts[MAX_PACKETS];
+    size_t n;
+} batch_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void add(series_t *s, uint64_t v) {
+    if (s->n == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 4096;
+        s->v = realloc(s->v, s->cap * sizeof *s->v);
+        if (!s->v) exit(1);
+    }
+    s->v[s->n++] = v > UINT32_MAX ? UINT32_MAX : (uint32_t)v;
+    s->sum += v;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void collect(void *ctx, const packet_t *p) {
+    batch_t *b = ctx;
+    b->pkts[b->n++] = *p;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s capture.pecap [--speed X | --fast] [--sink null|file:<path>|uinput]\n", argv0);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL, *sink_spec = "null";
+    double speed = 1.0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--speed") && i + 1 < argc)
+            speed = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--fast"))
+            speed = 0;
+        else if (!strcmp(argv[i], "--sink") && i + 1 < argc)
+            sink_spec = argv[++i];
+        else if (!path && argv[i][0] != '-')
+            path = argv[i];
+        else
+            usage(argv[0]);
+    }
+    if (!path || speed < 0) usage(argv[0]);
+
+    capture_reader_t r;
+    if (!capture_reader_open(&r, path)) {
+        fprintf(stderr, "%s: not a capture\n", path);
+        return 1;
+    }
+    sink_t *sink = sink_open(sink_spec, r.label);
+    if (!sink) return 1;
+
+    static uint8_t buf[CAPTURE_MAX_READ];
+    static batch_t batch;
+    static series_t st[ST_COUNT];
+    parser_t ps;
+    bridge_t b;
+    parser_init(&ps);
+    bridge_init(&b, sink);
+
+    uint64_t records = 0, t_us = 0;
+    uint64_t start = now_ns();
+    long len;
+    while ((len = capture_next(&r, &t_us, buf)) > 0) {
+        if (speed > 0) {
+            uint64_t due = start + (uint64_t)(t_us * 1000.0 / speed);
+            struct timespec ts = { (time_t)(due / 1000000000u), (long)(due % 1000000000u) };
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+            add(&st[ST_LATE], now_ns() - due);
+        }
+
+        // Releases that fell due in the gap before this record go first.
+        uint64_t t0 = now_ns();
+        bridge_expire(&b, t_us);
+        uint64_t t1 = now_ns();
+        batch.n = 0;
+        parser_feed(&ps, buf, (size_t)len, collect, &batch);
+        uint64_t t2 = now_ns();
+        for (size_t i = 0; i < batch.n; i++) bridge_packet(&b, &batch.pkts[i], t_us);
+        uint64_t t3 = now_ns();
+        bridge_flush(&b);
+        uint64_t t4 = now_ns();
+
+        add(&st[ST_PARSE], t2 - t1);
+        add(&st[ST_MAP], t3 - t2);
+        add(&st[ST_INJECT], (t1 - t0) + (t4 - t3));
+        add(&st[ST_TOTAL], t4 - t0);
+        records++;
+    }
+    double wall = (now_ns() - start) / 1e9;
+    char speed_s[16] = "fast";
+    if (speed > 0) snprintf(speed_s, sizeof speed_s, "%g", speed);
+    bridge_release_all(&b);
+    if (len < 0) fprintf(stderr, "%s: truncated or corrupt after %llu records\n", path, (unsigned long long)records);
+
+    printf("replay file=%s label=%s speed=%s records=%llu bytes=%llu packets=%u reports=%u "
+           "garbage=%llu resyncs=%llu duration_s=%.3f wall_s=%.3f events_per_s=%.0f\n",
+           path, r.label[0] ? r.label : "-", speed_s,
+           (unsigned long long)records, (unsigned long long)ps.stats.bytes, b.stats.packets,
+           b.stats.reports, (unsigned long long)ps.stats.garbage,
+           (unsigned long long)ps.stats.resyncs, t_us / 1e6, wall, b.stats.packets / wall);
+    for (int s = 0; s < ST_COUNT; s++) {
+        if (!st[s].n || s == ST_LATE) continue;
+        printf("kbench port=replay test=%s n=%zu ns_per_op=%.1f\n",
+               stage_names[s], st[s].n, (double)st[s].sum / st[s].n);
+    }
+    for (int s = 0; s < ST_COUNT; s++) {
+        series_t *x = &st[s];
+        if (!x->n) continue;
+        qsort(x->v, x->n, sizeof *x->v, cmp_u32);
+        printf("replay stage=%s n=%zu p50_ns=%u p99_ns=%u max_ns=%u\n",
+               stage_names[s], x->n, x->v[x->n / 2], x->v[x->n * 99 / 100], x->v[x->n - 1]);
+        free(x->v);
+    }
+
+    capture_reader_close(&r);
+    sink_close(sink);
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include "shm_export.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <linux/input-event-codes.h>
+
+#include "ctlstate.h"
+#include "evloop.h"
+
+struct shm_export {
+    ctl_shm_t *shm;
+    ctl_state_t cur;        // private copy, published per frame
+    uint64_t head;
+    char name[64];
+};
+
+shm_export_t *shm_export_open(const char *label) {
+    shm_export_t *e = calloc(1, sizeof *e);
+    if (!e) return NULL;
+    snprintf(e->name, sizeof e->name, CTL_SHM_PREFIX "%s", label);
+    int fd = shm_open(e->name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0 || ftruncate(fd, sizeof *e->shm) < 0) {
+        perror(e->name);
+        if (fd >= 0) close(fd);
+        free(e);
+        return NULL;
+    }
+    e->shm = mmap(NULL, sizeof *e->shm, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (e->shm == MAP_FAILED) {
+        perror(e->name);
+        free(e);
+        return NULL;
+    }
+
+    // Readers check the magic last, so a half-initialised segment is
+    // never accepted.
+    __atomic_store_n(&e->shm->magic, 0, __ATOMIC_RELAXED);
+    memset((char *)e->shm + sizeof e->shm->magic, 0, sizeof *e->shm - sizeof e->shm->magic);
+    e->shm->version = CTL_VERSION;
+    e->shm->ring_size = CTL_RING_SIZE;
+    e->shm->pid = (uint32_t)getpid();
+    snprintf(e->shm->label, sizeof e->shm->label, "%s", label);
+    __atomic_store_n(&e->shm->magic, CTL_MAGIC, __ATOMIC_RELEASE);
+    return e;
+}
+
+void shm_export_close(shm_export_t *e) {
+    if (!e) return;
+    shm_export_attached(e, false);
+    munmap(e->shm, sizeof *e->shm);
+    shm_unlink(e->name);
+    free(e);
+}
+
+static uint32_t button_bit(uint8_t code) {
+    switch (code) {
+    case ' ': return CTL_BTN_SPACE;
+    case 'R': return CTL_BTN_R;
+    case 'E': return CTL_BTN_E;
+    case 1:   return CTL_BTN_RIGHT;
+    case 2:   return CTL_BTN_SHIFT;
+    default:  return 0;
+    }
+}
+
+void shm_export_event(shm_export_t *e, const packet_t *p, uint64_t t_us) {
+    ctl_event_t *slot = &e->shm->ring[e->head % CTL_RING_SIZE];
+
+    // Slot seqlock: 0 while the slot changes, then the event's number.
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->t_us = t_us;
+    slot->hdr = p->hdr;
+    slot->id = p->id;
+    slot->val = p->val;
+    __atomic_store_n(&slot->seq, e->head + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&e->shm->head, ++e->head, __ATOMIC_RELEASE);
+
+    ctl_state_t *s = &e->cur;
+    s->packets++;
+    if (p->hdr == PKT_AXIS_HDR) {
+        if (p->id == 0) {
+            s->dx = p->val;
+            s->pos_x += p->val;
+        } else if (p->id == 1) {
+            s->dy = p->val;
+            s->pos_y += p->val;
+        }
+    } else if (p->hdr == PKT_BUTTON_HDR) {
+        // The firmware only sends presses (state 1): a button is a tap,
+        // set for the frame it arrives in (shm_export_frame clears it).
+        if (p->val == 1) s->buttons |= button_bit(p->id);
+    }
+}
+
+static void publish(shm_export_t *e) {
+    uint32_t seq = e->shm->seq;
+    __atomic_store_n(&e->shm->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&e->shm->state, &e->cur, sizeof e->cur);
+    __atomic_store_n(&e->shm->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static uint8_t dir_letter(uint16_t key) {
+    switch (key) {
+    case 0:     return 0;
+    case KEY_W: return 'W';
+    case KEY_A: return 'A';
+    case KEY_S: return 'S';
+    case KEY_D: return 'D';
+    default:    return '?';
+    }
+}
+
+void shm_export_frame(shm_export_t *e, const bridge_t *b, uint64_t t_rx_us) {
+    e->cur.frame++;
+    e->cur.t_rx_us = t_rx_us;
+    e->cur.dir[0] = dir_letter(b->held[0]);
+    e->cur.dir[1] = dir_letter(b->held[1]);
+    e->cur.t_pub_us = evloop_now_us();
+    publish(e);
+    e->cur.buttons = 0;
+}
+
+void shm_export_attached(shm_export_t *e, bool attached) {
+    if (!attached) {
+        // Whatever was held is released with the tty (device_detach).
+        e->cur.dir[0] = e->cur.dir[1] = 0;
+        e->cur.dx = e->cur.dy = 0;
+    }
+    e->cur.attached = attached;
+    e->cur.t_pub_us = evloop_now_us();
+    publish(e);
+}
@@ -0,0 +1,28 @@
+#ifndef SHM_EXPORT_H
+#define SHM_EXPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bridge.h"
+#include "packet.h"
+
+// Writer side of ctlstate.h: the bridge keeps the decoded state of one
+// controller in private memory, appends each packet to the shared event
+// ring as it is parsed and publishes the state block once per frame.
+typedef struct shm_export shm_export_t;
+
+// Creates (or takes over) /pico_emb.<label>; NULL on error.
+shm_export_t *shm_export_open(const char *label);
+
+// Removes the segment; readers that still map it keep the last state.
+void shm_export_close(shm_export_t *e);
+
+void shm_export_event(shm_export_t *e, const packet_t *p, uint64_t t_us);
+
+// Publishes the frame: state as of the last event, held WASD keys from b.
+void shm_export_frame(shm_export_t *e, const bridge_t *b, uint64_t t_rx_us);
+
+void shm_export_attached(shm_export_t *e, bool attached);
+
+#endif // SHM_EXPORT_H
@@ -0,0 +1,43 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Where the bridge's input events go. Events use the Linux input codes
+// (EV_REL/REL_X, EV_KEY/KEY_A, EV_SYN/SYN_REPORT, ...) whatever the sink,
+// so a file sink records exactly what uinput would have been given.
+typedef struct sink sink_t;
+
+struct sink {
+    bool (*emit)(sink_t *s, uint16_t type, uint16_t code, int32_t value);
+    void (*close)(sink_t *s);
+    const char *name;
+};
+
+static inline bool sink_emit(sink_t *s, uint16_t type, uint16_t code, int32_t value) {
+    return s->emit(s, type, code, value);
+}
+
+static inline void sink_close(sink_t *s) {
+    if (s->close) s->close(s);
+}
+
+// Virtual mouse + keyboard on /dev/uinput; NULL if the device cannot be
+// opened or created (no module, no permission).
+sink_t *sink_uinput_open(const char *devname);
+
+// One text line per event ("EV_REL REL_X -3", a blank line after each
+// SYN_REPORT); path "-" is stdout. For running without uinput and for
+// diffing the output of two builds.
+sink_t *sink_file_open(const char *path);
+
+// Discards everything; used by benchmarks.
+sink_t *sink_null_open(void);
+
+// Parses "uinput", "file:<path>" or "null". label tells controllers
+// apart: it ends the uinput device name, and replaces "%s" in a file
+// path (give one when several controllers are bridged).
+sink_t *sink_open(const char *spec, const char *label);
+
+#endif // SINK_H
@@ -0,0 +1,114 @@
+#include "sink.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <linux/input-event-codes.h>
+
+typedef struct {
+    sink_t base;
+    FILE *f;
+} sink_file_t;
+
+static const char *type_name(uint16_t type) {
+    switch (type) {
+    case EV_SYN: return "EV_SYN";
+    case EV_KEY: return "EV_KEY";
+    case EV_REL: return "EV_REL";
+    default:     return "EV_?";
+    }
+}
+
+static const char *code_name(uint16_t type, uint16_t code) {
+    static char other[8];
+    if (type == EV_SYN && code == SYN_REPORT) return "SYN_REPORT";
+    if (type == EV_REL) {
+        if (code == REL_X) return "REL_X";
+        if (code == REL_Y) return "REL_Y";
+    }
+    if (type == EV_KEY) {
+        switch (code) {
+        case KEY_W:         return "KEY_W";
+        case KEY_A:         return "KEY_A";
+        case KEY_S:         return "KEY_S";
+        case KEY_D:         return "KEY_D";
+        case KEY_E:         return "KEY_E";
+        case KEY_R:         return "KEY_R";
+        case KEY_SPACE:     return "KEY_SPACE";
+        case KEY_LEFTSHIFT: return "KEY_LEFTSHIFT";
+        case KEY_UP:        return "KEY_UP";
+        case KEY_DOWN:      return "KEY_DOWN";
+        case KEY_LEFT:      return "KEY_LEFT";
+        case KEY_RIGHT:     return "KEY_RIGHT";
+        case BTN_LEFT:      return "BTN_LEFT";
+        case BTN_RIGHT:     return "BTN_RIGHT";
+        }
+    }
+    snprintf(other, sizeof other, "%u", code);
+    return other;
+}
+
+static bool file_emit(sink_t *s, uint16_t type, uint16_t code, int32_t value) {
+    sink_file_t *f = (sink_file_t *)s;
+    int n = fprintf(f->f, "%s %s %d\n", type_name(type), code_name(type, code), (int)value);
+    if (type == EV_SYN) {
+        fputc('\n', f->f);
+        fflush(f->f);
+    }
+    return n > 0;
+}
+
+static void file_close(sink_t *s) {
+    sink_file_t *f = (sink_file_t *)s;
+    if (f->f != stdout) fclose(f->f);
+    else fflush(stdout);
+    free(f);
+}
+
+sink_t *sink_file_open(const char *path) {
+    FILE *fp = strcmp(path, "-") ? fopen(path, "w") : stdout;
+    if (!fp) {
+        perror(path);
+        return NULL;
+    }
+    sink_file_t *f = calloc(1, sizeof *f);
+    if (!f) {
+        if (fp != stdout) fclose(fp);
+        return NULL;
+    }
+    f->base.emit = file_emit;
+    f->base.close = file_close;
+    f->base.name = "file";
+    f->f = fp;
+    return &f->base;
+}
+
+static bool null_emit(sink_t *s, uint16_t type, uint16_t code, int32_t value) {
+    (void)s; (void)type; (void)code; (void)value;
+    return true;
+}
+
+sink_t *sink_null_open(void) {
+    static sink_t null_sink = { null_emit, NULL, "null" };
+    return &null_sink;
+}
+
+sink_t *sink_open(const char *spec, const char *label) {
+    char buf[256];
+    if (!strcmp(spec, "uinput")) {
+        snprintf(buf, sizeof buf, "Shell Shockers controller %s", label);
+        return sink_uinput_open(buf);
+    }
+    if (!strncmp(spec, "file:", 5)) {
+        const char *path = spec + 5, *mark = strstr(path, "%s");
+        if (mark) {
+            snprintf(buf, sizeof buf, "%.*s%s%s", (int)(mark - path), path, label, mark + 2);
+            path = buf;
+        }
+        return sink_file_open(path);
+    }
+    if (!strcmp(spec, "null"))
+        return sink_null_open();
+    fprintf(stderr, "unknown sink '%s' (uinput, file:<path>, null)\n", spec);
+    return NULL;
+}
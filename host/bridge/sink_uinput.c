@@ -0,0 +1,82 @@
+#include "sink.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
+
+typedef struct {
+    sink_t base;
+    int fd;
+} sink_uinput_t;
+
+// Every key the bridge can produce (bridge.c).
+static const uint16_t keys[] = {
+    KEY_W, KEY_A, KEY_S, KEY_D, KEY_E, KEY_R, KEY_SPACE, KEY_LEFTSHIFT,
+    KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT,
+    BTN_LEFT, BTN_RIGHT,
+};
+
+static bool uinput_emit(sink_t *s, uint16_t type, uint16_t code, int32_t value) {
+    sink_uinput_t *u = (sink_uinput_t *)s;
+    struct input_event ev;
+    memset(&ev, 0, sizeof ev);     // the kernel stamps the time
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    return write(u->fd, &ev, sizeof ev) == (ssize_t)sizeof ev;
+}
+
+static void uinput_close(sink_t *s) {
+    sink_uinput_t *u = (sink_uinput_t *)s;
+    ioctl(u->fd, UI_DEV_DESTROY);
+    close(u->fd);
+    free(u);
+}
+
+sink_t *sink_uinput_open(const char *devname) {
+    int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+    if (fd < 0) {
+        fprintf(stderr, "/dev/uinput: %s\n", strerror(errno));
+        return NULL;
+    }
+
+    // A pointer device needs a button besides REL_X/REL_Y, or libinput
+    // does not treat it as a mouse.
+    bool ok = ioctl(fd, UI_SET_EVBIT, EV_KEY) == 0 &&
+              ioctl(fd, UI_SET_EVBIT, EV_REL) == 0 &&
+              ioctl(fd, UI_SET_EVBIT, EV_SYN) == 0 &&
+              ioctl(fd, UI_SET_RELBIT, REL_X) == 0 &&
+              ioctl(fd, UI_SET_RELBIT, REL_Y) == 0;
+    for (size_t i = 0; ok && i < sizeof keys / sizeof keys[0]; i++)
+        ok = ioctl(fd, UI_SET_KEYBIT, keys[i]) == 0;
+
+    struct uinput_setup setup;
+    memset(&setup, 0, sizeof setup);
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x2e8a;      // Raspberry Pi, as the controller itself
+    setup.id.product = 0x5343;
+    snprintf(setup.name, sizeof setup.name, "%s", devname);
+    ok = ok && ioctl(fd, UI_DEV_SETUP, &setup) == 0 && ioctl(fd, UI_DEV_CREATE) == 0;
+    if (!ok) {
+        fprintf(stderr, "uinput setup: %s\n", strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    sink_uinput_t *u = calloc(1, sizeof *u);
+    if (!u) {
+        ioctl(fd, UI_DEV_DESTROY);
+        close(fd);
+        return NULL;
+    }
+    u->base.emit = uinput_emit;
+    u->base.close = uinput_close;
+    u->base.name = "uinput";
+    u->fd = fd;
+    return &u->base;
+}
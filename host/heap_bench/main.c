@@ -0,0 +1,147 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef HEAP_BENCH_TLSF
+#include "heap_tlsf.h"
+#endif
+
+// heap_bench_<heap> [ops]: boot-like allocation sequence followed by a
+// random churn, one result line per measurement (key=value, times in ns).
+
+// Scheduler hooks used by the heaps; nothing to suspend here.
+void vTaskSuspendAll(void) {}
+BaseType_t xTaskResumeAll(void) { return pdFALSE; }
+void vPortEnterCritical(void) {}
+void vPortExitCritical(void) {}
+
+#define LIVE_MAX 256
+
+typedef struct {
+    const char *name;
+    uint32_t n;
+    uint64_t total, min, max;
+    uint32_t *samples;
+} op_stats_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void record(op_stats_t *s, uint64_t dt) {
+    if (!s->n || dt < s->min) s->min = dt;
+    if (dt > s->max) s->max = dt;
+    s->total += dt;
+    s->samples[s->n++] = (uint32_t)dt;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *phase, op_stats_t *s) {
+    if (!s->n) return;
+    qsort(s->samples, s->n, sizeof(uint32_t), cmp_u32);
+    printf("heap=%s phase=%s op=%s n=%u min_ns=%llu mean_ns=%.1f p50_ns=%u "
+           "p99_ns=%u p9999_ns=%u max_ns=%llu\n",
+           HEAP_NAME, phase, s->name, s->n, (unsigned long long)s->min,
+           (double)s->total / s->n, s->samples[s->n / 2],
+           s->samples[(uint64_t)s->n * 99 / 100],
+           s->samples[(uint64_t)s->n * 9999 / 10000],
+           (unsigned long long)s->max);
+}
+
+static void *timed_malloc(op_stats_t *s, size_t size, uint32_t *failed) {
+    uint64_t t0 = now_ns();
+    void *p = pvPortMalloc(size);
+    record(s, now_ns() - t0);
+    if (!p) (*failed)++;
+    return p;
+}
+
+static void timed_free(op_stats_t *s, void *p) {
+    uint64_t t0 = now_ns();
+    vPortFree(p);
+    record(s, now_ns() - t0);
+}
+
+static uint32_t rng = 0x2545F491u;
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void report_fragmentation(void) {
+#if defined(HEAP_BENCH_TLSF)
+    HeapTelemetry_t t;
+    vPortGetHeapTelemetry(&t);
+    printf("heap=%s phase=end free_bytes=%zu largest_free=%zu free_blocks=%zu "
+           "peak_in_use=%zu failed=%zu\n",
+           HEAP_NAME, t.xFreeBytes, t.xLargestFreeBlock, t.xFreeBlocks,
+           t.xPeakBytesInUse, t.xFailedAllocations);
+#elif defined(HEAP_BENCH_HEAP_4)
+    HeapStats_t h;
+    vPortGetHeapStats(&h);
+    printf("heap=%s phase=end free_bytes=%zu largest_free=%zu free_blocks=%zu\n",
+           HEAP_NAME, h.xAvailableHeapSpaceInBytes,
+           h.xSizeOfLargestFreeBlockInBytes, h.xNumberOfFreeBlocks);
+#else
+    printf("heap=%s phase=end free_bytes=n/a largest_free=n/a\n", HEAP_NAME);
+#endif
+}
+
+int main(int argc, char **argv) {
+    uint32_t ops = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 200000;
+    uint32_t failed = 0;
+
+    op_stats_t boot = {.name = "malloc"};
+    boot.samples = calloc(64, sizeof(uint32_t));
+
+    // What main() creates: 3 queues + 1 semaphore (struct + storage),
+    // 8 tasks (TCB + stack), the idle and timer tasks.
+    static const size_t boot_sizes[] = {
+        80 + 32 * 12, 80 + 32 * 2, 80 + 8, 80,
+        160, 8192, 160, 8192, 160, 8192, 160, 8192, 160, 8192,
+        160, 4096, 160, 4096, 160, 4096, 160, 512, 160, 512,
+    };
+    for (size_t i = 0; i < sizeof(boot_sizes) / sizeof(boot_sizes[0]); i++)
+        timed_malloc(&boot, boot_sizes[i], &failed);
+    report("boot", &boot);
+
+    op_stats_t alloc = {.name = "malloc"}, release = {.name = "free"};
+    alloc.samples = calloc(ops, sizeof(uint32_t));
+    release.samples = calloc(ops, sizeof(uint32_t));
+    void *live[LIVE_MAX] = {0};
+
+    // Mixed small/medium sizes with a long tail, freed in random order.
+    for (uint32_t i = 0; i < ops; i++) {
+        uint32_t slot = xorshift() % LIVE_MAX;
+        if (live[slot]) {
+            timed_free(&release, live[slot]);
+            live[slot] = NULL;
+        } else {
+            uint32_t r = xorshift();
+            size_t size = (r & 3) ? 16 + (r >> 8) % 240 : 256 + (r >> 8) % 3840;
+            live[slot] = timed_malloc(&alloc, size, &failed);
+        }
+    }
+    report("churn", &alloc);
+    report("churn", &release);
+
+    for (int i = 0; i < LIVE_MAX; i++)
+        if (live[i]) vPortFree(live[i]);
+    report_fragmentation();
+    printf("heap=%s failed_allocations=%u\n", HEAP_NAME, failed);
+
+    return 0;
+}
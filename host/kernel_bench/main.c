@@ -0,0 +1,46 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "kbench.h"
+
+// kernel_bench [ops]: bench/kbench.c on the Posix port. There are no
+// interrupts here, so the *_isr_* rows call the FromISR API from the
+// benchmark task; they still exercise the same kernel paths.
+
+const char *const kbench_port = "posix";
+
+static void (*isr_handler)(void);
+static uint32_t ops;
+
+uint64_t kbench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+void kbench_isr_install(void (*handler)(void)) {
+    isr_handler = handler;
+}
+
+void kbench_isr_trigger(void) {
+    isr_handler();
+}
+
+static void bench_task(void *p) {
+    (void)p;
+    kbench_run(ops);
+    fflush(stdout);
+    exit(0);
+}
+
+int main(int argc, char **argv) {
+    ops = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+    xTaskCreate(bench_task, "kbench", configMINIMAL_STACK_SIZE, NULL, KBENCH_PRIO, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
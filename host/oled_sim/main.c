@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gfx.h"
+#include "hud_draw.h"
+#include "ssd1306_sim.h"
+
+// oled_sim: runs oled1_lib against the emulated controller.
+//
+//   oled_sim --scene hud --out hud.pbm      render a scene to PBM
+//   oled_sim --scene hud --golden hud.pbm   compare with a golden image
+//   oled_sim --bench 1000                   bytes/transactions per show
+
+static ssd1306_t disp;
+static gfx_glyph_cache_t font1, font2;
+static uint32_t font1_bits[GFX_FONT_8X5_CACHE_WORDS];
+static uint32_t font2_bits[GFX_FONT_8X5_CACHE_WORDS];
+
+// The HUD is drawn by main/hud_draw.c, the same code the firmware runs.
+static void scene_hud(void) {
+    hud_values_t v = {
+        .sr = 500, .tx = 212, .enabled = true, .qa = 3, .qb = 0, .drops = 17,
+        .lat = 840, .lat_max = 2310, .idle = 96, .gain = 4, .zona_morta = 150,
+    };
+    hud_draw_labels(&disp, &font1);
+    hud_draw_fields(&disp, &font1, &v);
+}
+
+static void scene_text(void) {
+    gfx_draw_string(&disp, 0, 0, 1, "font_8x5 scale 1");
+    gfx_draw_string_cached(&disp, &font1, 0, 9, "cached, y=9");
+    gfx_draw_string_cached(&disp, &font2, 0, 17, "x2 42");
+    gfx_draw_uint_field(&disp, &font2, 70, 17, 4, 1234);
+}
+
+static void scene_shapes(void) {
+    gfx_draw_line(&disp, 0, 0, 127, GFX_MONO_LCD_HEIGHT - 1);
+    gfx_draw_line(&disp, 0, GFX_MONO_LCD_HEIGHT - 1, 127, 0);
+    gfx_draw_line(&disp, 64, 0, 64, GFX_MONO_LCD_HEIGHT - 1);
+    gfx_draw_pixel(&disp, 127, 0);
+}
+
+static const struct {
+    const char *name;
+    void (*draw)(void);
+} scenes[] = {
+    {"hud", scene_hud},
+    {"text", scene_text},
+    {"shapes", scene_shapes},
+};
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *what, int frames, double secs) {
+    printf("%-10s frames=%d cmd_bytes/frame=%.1f data_bytes/frame=%.1f "
+           "transactions/frame=%.1f host_us/frame=%.2f\n",
+           what, frames, (double)ssd1306_sim_stats.cmd_bytes / frames,
+           (double)ssd1306_sim_stats.data_bytes / frames,
+           (double)ssd1306_sim_stats.transactions / frames,
+           secs * 1e6 / frames);
+}
+
+// HUD refresh where a few counters move every frame, flushed both ways.
+static void bench(int frames) {
+    hud_values_t v = {
+        .sr = 500, .tx = 200, .enabled = true, .lat = 800, .lat_max = 2000,
+        .idle = 95, .gain = 4, .zona_morta = 150,
+    };
+
+    for (int pass = 0; pass < 2; pass++) {
+        gfx_clear_buffer(&disp);
+        hud_draw_labels(&disp, &font1);
+        gfx_show(&disp);
+        ssd1306_sim_reset_stats();
+
+        double t0 = now_s();
+        for (int i = 0; i < frames; i++) {
+            v.sr = 495 + i % 11;
+            v.tx = 180 + i % 40;
+            v.qa = i % 4;
+            v.lat = 700 + (i * 37) % 400;
+            v.idle = 94 + i % 3;
+            hud_draw_fields(&disp, &font1, &v);
+            if (pass)
+                gfx_show_dirty(&disp);
+            else
+                gfx_show(&disp);
+        }
+        report(pass ? "show_dirty" : "show", frames, now_s() - t0);
+    }
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--scene hud|text|shapes] [--out file.pbm]\n"
+            "          [--golden file.pbm] [--bench frames]\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    const char *scene = "hud", *out = NULL, *golden = NULL;
+    int frames = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--scene") && i + 1 < argc)
+            scene = argv[++i];
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc)
+            out = argv[++i];
+        else if (!strcmp(argv[i], "--golden") && i + 1 < argc)
+            golden = argv[++i];
+        else if (!strcmp(argv[i], "--bench") && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    ssd1306_init();
+    gfx_init(&disp, GFX_MONO_LCD_WIDTH, GFX_MONO_LCD_HEIGHT);
+    gfx_glyph_cache_init(&font1, 1, font1_bits, GFX_FONT_8X5_CACHE_WORDS);
+    gfx_glyph_cache_init(&font2, 2, font2_bits, GFX_FONT_8X5_CACHE_WORDS);
+
+    if (frames > 0) {
+        bench(frames);
+        return 0;
+    }
+
+    size_t n;
+    for (n = 0; n < sizeof(scenes) / sizeof(scenes[0]); n++)
+        if (!strcmp(scenes[n].name, scene))
+            break;
+    if (n == sizeof(scenes) / sizeof(scenes[0])) {
+        fprintf(stderr, "unknown scene '%s'\n", scene);
+        return 2;
+    }
+
+    scenes[n].draw();
+    ssd1306_sim_reset_stats();
+    gfx_show(&disp);
+    printf("scene=%s cmd_bytes=%u data_bytes=%u transactions=%u unknown=%u\n",
+           scene, ssd1306_sim_stats.cmd_bytes, ssd1306_sim_stats.data_bytes,
+           ssd1306_sim_stats.transactions, ssd1306_sim_stats.unknown);
+
+    if (out && !ssd1306_sim_write_pbm(out)) {
+        perror(out);
+        return 1;
+    }
+
+    if (golden) {
+        long diff = ssd1306_sim_compare_pbm(golden);
+        if (diff != 0) {
+            fprintf(stderr, "%s: %s\n", golden,
+                    diff < 0 ? "missing or wrong size" : "image differs");
+            if (diff > 0)
+                fprintf(stderr, "%ld pixels differ\n", diff);
+            return 1;
+        }
+        printf("%s: match\n", golden);
+    }
+
+    return 0;
+}
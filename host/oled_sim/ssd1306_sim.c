@@ -0,0 +1,247 @@
+#include "ssd1306_sim.h"
+#include "ssd1306.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Host bus backend for oled1_lib: instead of driving SPI, every byte is fed
+// to a model of the controller's command decoder and GDDRAM.
+
+ssd1306_sim_t ssd1306_sim;
+ssd1306_sim_stats_t ssd1306_sim_stats;
+
+static void sim_power_on_defaults(void) {
+    memset(&ssd1306_sim, 0, sizeof(ssd1306_sim));
+    ssd1306_sim.mode = 2;
+    ssd1306_sim.col_end = SSD1306_SIM_COLUMNS - 1;
+    ssd1306_sim.page_end = SSD1306_SIM_PAGES - 1;
+    ssd1306_sim.mux = SSD1306_SIM_ROWS - 1;
+    ssd1306_sim.contrast = 0x7F;
+}
+
+static uint8_t sim_arg_count(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void sim_execute(uint8_t cmd, const uint8_t *a) {
+    ssd1306_sim_t *s = &ssd1306_sim;
+
+    if (cmd <= 0x0F) {
+        s->page_mode_col = (s->page_mode_col & 0x70) | cmd;
+        s->col = s->page_mode_col;
+    } else if (cmd <= 0x17) {
+        s->page_mode_col = (s->page_mode_col & 0x0F) | ((cmd & 0x07) << 4);
+        s->col = s->page_mode_col;
+    } else if (cmd >= 0x40 && cmd <= 0x7F) {
+        s->start_line = cmd & 0x3F;
+    } else if (cmd >= 0xB0 && cmd <= 0xB7) {
+        s->page = cmd & 0x07;
+    } else {
+        switch (cmd) {
+        case 0x20: s->mode = a[0] & 0x03; break;
+        case 0x21:
+            s->col_start = s->col = a[0] & 0x7F;
+            s->col_end = a[1] & 0x7F;
+            break;
+        case 0x22:
+            s->page_start = s->page = a[0] & 0x07;
+            s->page_end = a[1] & 0x07;
+            break;
+        case 0x81: s->contrast = a[0]; break;
+        case 0x8D: s->charge_pump = a[0] & 0x04; break;
+        case 0xA0: s->seg_remap = false; break;
+        case 0xA1: s->seg_remap = true; break;
+        case 0xA4: s->entire_on = false; break;
+        case 0xA5: s->entire_on = true; break;
+        case 0xA6: s->inverse = false; break;
+        case 0xA7: s->inverse = true; break;
+        case 0xA8: if ((a[0] & 0x3F) >= 15) s->mux = a[0] & 0x3F; break;
+        case 0xAE: s->display_on = false; break;
+        case 0xAF: s->display_on = true; break;
+        case 0xC0: s->com_scan_down = false; break;
+        case 0xC8: s->com_scan_down = true; break;
+        case 0xD3: s->offset = a[0] & 0x3F; break;
+        // Timing, scrolling and NOP: no effect on the image model.
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB: case 0xE3:
+        case 0x26: case 0x27: case 0x29: case 0x2A: case 0x2E: case 0x2F:
+        case 0xA3:
+            break;
+        default:
+            ssd1306_sim_stats.unknown++;
+            break;
+        }
+    }
+}
+
+static void sim_command(uint8_t b) {
+    ssd1306_sim_t *s = &ssd1306_sim;
+
+    ssd1306_sim_stats.cmd_bytes++;
+    if (s->want) {
+        s->args[s->nargs++] = b;
+        if (s->nargs == s->want) {
+            s->want = 0;
+            sim_execute(s->pending, s->args);
+        }
+        return;
+    }
+
+    s->want = sim_arg_count(b);
+    s->nargs = 0;
+    s->pending = b;
+    if (!s->want)
+        sim_execute(b, s->args);
+}
+
+static void sim_data(uint8_t b) {
+    ssd1306_sim_t *s = &ssd1306_sim;
+
+    ssd1306_sim_stats.data_bytes++;
+    s->gddram[s->page & 0x07][s->col & 0x7F] = b;
+
+    switch (s->mode) {
+    case 0: // horizontal
+        if (s->col++ >= s->col_end) {
+            s->col = s->col_start;
+            if (s->page++ >= s->page_end)
+                s->page = s->page_start;
+        }
+        break;
+    case 1: // vertical
+        if (s->page++ >= s->page_end) {
+            s->page = s->page_start;
+            if (s->col++ >= s->col_end)
+                s->col = s->col_start;
+        }
+        break;
+    default: // page
+        if (s->col++ >= SSD1306_SIM_COLUMNS - 1)
+            s->col = s->page_mode_col;
+        break;
+    }
+}
+
+void ssd1306_interface_init(void) {}
+
+void ssd1306_hard_reset(void) { sim_power_on_defaults(); }
+
+void ssd1306_write_command(uint8_t command) {
+    ssd1306_sim_stats.transactions++;
+    sim_command(command);
+}
+
+void ssd1306_write_data(uint8_t data) {
+    ssd1306_sim_stats.transactions++;
+    sim_data(data);
+}
+
+void ssd1306_write_commands(const uint8_t *commands, size_t len) {
+    ssd1306_sim_stats.transactions++;
+    while (len--)
+        sim_command(*commands++);
+}
+
+void ssd1306_write_data_buf(const uint8_t *data, size_t len) {
+    ssd1306_sim_stats.transactions++;
+    while (len--)
+        sim_data(*data++);
+}
+
+void ssd1306_init_async(void) { ssd1306_init(); }
+
+bool ssd1306_init_done(void) { return true; }
+
+void ssd1306_sim_reset_stats(void) {
+    memset(&ssd1306_sim_stats, 0, sizeof(ssd1306_sim_stats));
+}
+
+int ssd1306_sim_render(uint8_t *pixels, size_t size) {
+    const ssd1306_sim_t *s = &ssd1306_sim;
+    int rows = s->mux + 1;
+
+    if (size < (size_t)rows * SSD1306_SIM_COLUMNS)
+        return -1;
+
+    for (int y = 0; y < rows; y++) {
+        int com = s->com_scan_down ? y : rows - 1 - y;
+        int ram_row = (com + s->start_line + s->offset) & (SSD1306_SIM_ROWS - 1);
+        for (int x = 0; x < SSD1306_SIM_COLUMNS; x++) {
+            int col = s->seg_remap ? x : SSD1306_SIM_COLUMNS - 1 - x;
+            uint8_t on = (s->gddram[ram_row >> 3][col] >> (ram_row & 7)) & 1;
+            if (s->entire_on)
+                on = 1;
+            on ^= s->inverse;
+            if (!s->display_on)
+                on = 0;
+            pixels[y * SSD1306_SIM_COLUMNS + x] = on;
+        }
+    }
+
+    return rows;
+}
+
+bool ssd1306_sim_write_pbm(const char *path) {
+    uint8_t pixels[SSD1306_SIM_ROWS * SSD1306_SIM_COLUMNS];
+    int rows = ssd1306_sim_render(pixels, sizeof(pixels));
+
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    fprintf(f, "P4\n%d %d\n", SSD1306_SIM_COLUMNS, rows);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < SSD1306_SIM_COLUMNS; x += 8) {
+            uint8_t b = 0;
+            for (int i = 0; i < 8; i++)
+                b |= pixels[y * SSD1306_SIM_COLUMNS + x + i] << (7 - i);
+            fputc(b, f);
+        }
+    }
+
+    return fclose(f) == 0;
+}
+
+long ssd1306_sim_compare_pbm(const char *path) {
+    uint8_t pixels[SSD1306_SIM_ROWS * SSD1306_SIM_COLUMNS];
+    int rows = ssd1306_sim_render(pixels, sizeof(pixels));
+    int w, h;
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return -1;
+
+    if (fscanf(f, "P4 %d %d", &w, &h) != 2 || fgetc(f) == EOF ||
+        w != SSD1306_SIM_COLUMNS || h != rows) {
+        fclose(f);
+        return -1;
+    }
+
+    long diff = 0;
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < SSD1306_SIM_COLUMNS; x += 8) {
+            int b = fgetc(f);
+            if (b == EOF) {
+                fclose(f);
+                return -1;
+            }
+            for (int i = 0; i < 8; i++)
+                diff += ((b >> (7 - i)) & 1) != pixels[y * SSD1306_SIM_COLUMNS + x + i];
+        }
+    }
+
+    fclose(f);
+    return diff;
+}
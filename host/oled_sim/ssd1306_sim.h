@@ -0,0 +1,59 @@
+#ifndef SSD1306_SIM_H
+#define SSD1306_SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SSD1306_SIM_COLUMNS 128
+#define SSD1306_SIM_PAGES   8
+#define SSD1306_SIM_ROWS    (SSD1306_SIM_PAGES * 8)
+
+// Controller state as decoded from the command/data stream.
+typedef struct {
+    uint8_t gddram[SSD1306_SIM_PAGES][SSD1306_SIM_COLUMNS];
+
+    uint8_t mode;        /**< 0 horizontal, 1 vertical, 2 page */
+    uint8_t col_start, col_end;
+    uint8_t page_start, page_end;
+    uint8_t col, page;   /**< RAM pointers */
+    uint8_t page_mode_col; /**< column set by 0x00/0x10 in page mode */
+    uint8_t start_line;
+    uint8_t offset;
+    uint8_t mux;         /**< multiplex ratio - 1 */
+    bool seg_remap;      /**< 0xA1 */
+    bool com_scan_down;  /**< 0xC8 */
+    bool inverse;
+    bool entire_on;
+    bool display_on;
+    bool charge_pump;
+    uint8_t contrast;
+
+    uint8_t pending;     /**< command waiting for arguments */
+    uint8_t args[6];
+    uint8_t nargs, want;
+} ssd1306_sim_t;
+
+typedef struct {
+    uint32_t cmd_bytes;
+    uint32_t data_bytes;
+    uint32_t transactions; /**< CS/D-C bursts, one per backend call */
+    uint32_t unknown;      /**< command bytes the decoder did not know */
+} ssd1306_sim_stats_t;
+
+extern ssd1306_sim_t ssd1306_sim;
+extern ssd1306_sim_stats_t ssd1306_sim_stats;
+
+void ssd1306_sim_reset_stats(void);
+
+// Visible panel image, one byte per pixel (0/1), width 128, height mux + 1.
+// Orientation is the one the driver's init (0xA1, 0xC8) shows upright.
+int ssd1306_sim_render(uint8_t *pixels, size_t size);
+
+// PBM (P4) helpers; lit pixels are written as 1 (black ink).
+bool ssd1306_sim_write_pbm(const char *path);
+// Returns the number of differing pixels, or -1 if the golden image is
+// missing or has another size.
+long ssd1306_sim_compare_pbm(const char *path);
+
+#endif // SSD1306_SIM_H
@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+
+// signal_bench [rounds]: one result line per primitive (key=value, times
+// in ns), from just before the give to the first instruction of the
+// woken task. The waiter always has the higher priority, so the give
+// switches to it directly, as on the target.
+//
+//   before: sem       binary semaphore (xSemEnable)
+//           queue     1-byte token queue (xQueueBuzzer)
+//           resume5   vTaskResume on 5 suspended tasks (power_task)
+//   after:  notify    xTaskNotifyGiveIndexed / ulTaskNotifyTakeIndexed
+//           evgroup   xEventGroupSetBits with 1 waiter
+//           evgroup5  xEventGroupSetBits with 5 waiters (mode toggle)
+//
+// The Posix port switches tasks with signals between threads, so absolute
+// numbers are far above the RP2040's; compare the rows with each other.
+
+#define SIG_INDEX    2
+#define WAITERS      5
+#define WAKE_BIT     (1u << 0)
+
+typedef enum { SIG_SEM, SIG_QUEUE, SIG_RESUME5, SIG_NOTIFY, SIG_EVGROUP, SIG_EVGROUP5, SIG_KINDS } sig_kind_t;
+
+static const char *const sig_names[SIG_KINDS] = {
+    "sem", "queue", "resume5", "notify", "evgroup", "evgroup5",
+};
+static const char *const sig_sides[SIG_KINDS] = {
+    "before", "before", "before", "after", "after", "after",
+};
+
+typedef struct {
+    uint32_t n;
+    uint64_t total, min, max;
+    uint64_t *samples;
+} lat_stats_t;
+
+static SemaphoreHandle_t sem;
+static QueueHandle_t queue;
+static EventGroupHandle_t group;
+static TaskHandle_t waiters[WAITERS];
+static volatile sig_kind_t kind;
+static volatile uint64_t woke_ns;
+static volatile uint32_t woke_count;
+static uint32_t rounds;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void record(lat_stats_t *s, uint64_t dt) {
+    if (!s->n || dt < s->min) s->min = dt;
+    if (dt > s->max) s->max = dt;
+    s->total += dt;
+    s->samples[s->n++] = dt;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(sig_kind_t k, lat_stats_t *s) {
+    if (!s->n) return;
+    qsort(s->samples, s->n, sizeof(uint64_t), cmp_u64);
+    printf("side=%s signal=%s n=%u min_ns=%llu mean_ns=%.1f p50_ns=%llu p99_ns=%llu max_ns=%llu\n",
+           sig_sides[k], sig_names[k], s->n, (unsigned long long)s->min,
+           (double)s->total / s->n, (unsigned long long)s->samples[s->n / 2],
+           (unsigned long long)s->samples[(uint64_t)s->n * 99 / 100], (unsigned long long)s->max);
+    fflush(stdout);
+}
+
+// Waiter 0 serves every kind; the others only join the 5-way rows. The
+// last one to wake stamps the time.
+static void waiter_task(void *p) {
+    uintptr_t id = (uintptr_t)p;
+    uint8_t token;
+    while (1) {
+        switch (kind) {
+        case SIG_SEM:      xSemaphoreTake(sem, portMAX_DELAY); break;
+        case SIG_QUEUE:    xQueueReceive(queue, &token, portMAX_DELAY); break;
+        case SIG_RESUME5:  vTaskSuspend(NULL); break;
+        case SIG_NOTIFY:   ulTaskNotifyTakeIndexed(SIG_INDEX, pdTRUE, portMAX_DELAY); break;
+        case SIG_EVGROUP:
+        case SIG_EVGROUP5: xEventGroupWaitBits(group, WAKE_BIT, pdFALSE, pdTRUE, portMAX_DELAY); break;
+        default:           vTaskSuspend(NULL); continue;
+        }
+        if (++woke_count == ((kind == SIG_RESUME5 || kind == SIG_EVGROUP5) ? WAITERS : 1))
+            woke_ns = now_ns();
+        if (kind == SIG_EVGROUP || kind == SIG_EVGROUP5) {
+            // Park until the signaller clears the bit and re-arms.
+            vTaskSuspend(NULL);
+        } else if (id != 0 && kind != SIG_RESUME5) {
+            vTaskSuspend(NULL);
+        }
+    }
+}
+
+static void signal_once(sig_kind_t k) {
+    uint8_t token = 1;
+    switch (k) {
+    case SIG_SEM:     xSemaphoreGive(sem); break;
+    case SIG_QUEUE:   xQueueSend(queue, &token, 0); break;
+    case SIG_RESUME5: for (int i = 0; i < WAITERS; i++) vTaskResume(waiters[i]); break;
+    case SIG_NOTIFY:  xTaskNotifyGiveIndexed(waiters[0], SIG_INDEX); break;
+    case SIG_EVGROUP:
+    case SIG_EVGROUP5: xEventGroupSetBits(group, WAKE_BIT); break;
+    default: break;
+    }
+}
+
+static void signaller_task(void *p) {
+    (void)p;
+    lat_stats_t st;
+    st.samples = calloc(rounds, sizeof(uint64_t));
+
+    for (sig_kind_t k = 0; k < SIG_KINDS; k++) {
+        int active = (k == SIG_RESUME5 || k == SIG_EVGROUP5) ? WAITERS : 1;
+        st.n = 0;
+        st.total = st.max = st.min = 0;
+        kind = k;
+        // Let the waiters block on this kind's primitive.
+        for (int i = 0; i < active; i++) vTaskResume(waiters[i]);
+        vTaskDelay(2);
+
+        for (uint32_t r = 0; r < rounds; r++) {
+            woke_count = 0;
+            uint64_t t0 = now_ns();
+            signal_once(k);
+            // The give only readies the waiters; with several of them
+            // (and the Posix port's signal-driven switches) some may not
+            // have run yet, and woke_ns is only stamped by the last one.
+            while (woke_count < (uint32_t)active) taskYIELD();
+            record(&st, woke_ns - t0);
+            if (k == SIG_EVGROUP || k == SIG_EVGROUP5) {
+                xEventGroupClearBits(group, WAKE_BIT);
+                for (int i = 0; i < active; i++) vTaskResume(waiters[i]);
+            }
+        }
+        report(k, &st);
+
+        // Park everyone for the next kind: one more wake with the kind
+        // switched to "suspend".
+        kind = SIG_KINDS;
+        signal_once(k);
+        if (k == SIG_EVGROUP || k == SIG_EVGROUP5) xEventGroupClearBits(group, WAKE_BIT);
+        vTaskDelay(2);
+    }
+    free(st.samples);
+    exit(0);
+}
+
+int main(int argc, char **argv) {
+    rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+
+    sem = xSemaphoreCreateBinary();
+    queue = xQueueCreate(8, sizeof(uint8_t));
+    group = xEventGroupCreate();
+
+    // Waiters start suspended; the signaller releases them per kind.
+    kind = SIG_KINDS;
+    for (uintptr_t i = 0; i < WAITERS; i++)
+        xTaskCreate(waiter_task, "wait", configMINIMAL_STACK_SIZE, (void *)i, 2, &waiters[i]);
+    xTaskCreate(signaller_task, "signal", configMINIMAL_STACK_SIZE, NULL, 1, NULL);
+
+    vTaskStartScheduler();
+    return 1;
+}
@@ -0,0 +1,57 @@
+#include "app_tasks.h"
+#include "input.h"
+#include "hud.h"
+
+#define APP_TASK_WCET_SLOT(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    [APP_TASK_##id] = { .pcId = #id, .ulPeriodUs = (period), .ulDeadlineUs = (deadline) },
+
+WcetSlot_t app_wcet[APP_TASK_COUNT] = { APP_TASKS(APP_TASK_WCET_SLOT) };
+
+#if configSUPPORT_STATIC_ALLOCATION
+
+// V11.1 changed the stack size out-parameter to configSTACK_DEPTH_TYPE.
+#if tskKERNEL_VERSION_MAJOR > 11 || (tskKERNEL_VERSION_MAJOR == 11 && tskKERNEL_VERSION_MINOR >= 1)
+typedef configSTACK_DEPTH_TYPE app_stack_size_t;
+#else
+typedef uint32_t app_stack_size_t;
+#endif
+
+// Kernel-owned tasks, placed like the rows of APP_TASKS.
+static StackType_t app_stack_IDLE[configMINIMAL_STACK_SIZE] __attribute__((aligned(8))) APP_PLACE_NOINIT(stack_IDLE);
+static StaticTask_t app_tcb_IDLE APP_PLACE_BSS(tcb_IDLE);
+static StackType_t app_stack_Tmr[configTIMER_TASK_STACK_DEPTH] __attribute__((aligned(8))) APP_PLACE_NOINIT(stack_Tmr);
+static StaticTask_t app_tcb_Tmr APP_PLACE_BSS(tcb_Tmr);
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   app_stack_size_t *pulIdleTaskStackSize) {
+    *ppxIdleTaskTCBBuffer = &app_tcb_IDLE;
+    *ppxIdleTaskStackBuffer = app_stack_IDLE;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    app_stack_size_t *pulTimerTaskStackSize) {
+    *ppxTimerTaskTCBBuffer = &app_tcb_Tmr;
+    *ppxTimerTaskStackBuffer = app_stack_Tmr;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+#if configNUMBER_OF_CORES > 1
+// SMP: one passive idle task per extra core.
+static StackType_t app_stack_IDLE1[configMINIMAL_STACK_SIZE] __attribute__((aligned(8))) APP_PLACE_NOINIT(stack_IDLE1);
+static StaticTask_t app_tcb_IDLE1 APP_PLACE_BSS(tcb_IDLE1);
+
+void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                          StackType_t **ppxIdleTaskStackBuffer,
+                                          app_stack_size_t *pulIdleTaskStackSize,
+                                          BaseType_t xPassiveIdleTaskIndex) {
+    (void)xPassiveIdleTaskIndex;
+    *ppxIdleTaskTCBBuffer = &app_tcb_IDLE1;
+    *ppxIdleTaskStackBuffer = app_stack_IDLE1;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+#endif
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef APP_TASKS_H
+#define APP_TASKS_H
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <event_groups.h>
+#include <message_buffer.h>
+#include <semphr.h>
+#include "wcet.h"
+
+// Every kernel object the firmware creates at boot. With
+// FREERTOS_STATIC_ALLOCATION the TCBs, stacks and queue storage are laid
+// out from these rows at link time; otherwise the same rows drive
+// xTaskCreate/xQueueCreate. The rows are expanded in main.c, where the
+// entry points and item types are visible.
+//
+// Placement of stacks and queue storage:
+//   NOINIT     main SRAM, not zeroed by crt0 (default)
+//   BSS        main SRAM, zeroed at boot
+//   SCRATCH_X  SRAM bank 4 (4 KB, the top 2 KB hold the core 1 stack)
+//   SCRATCH_Y  SRAM bank 5 (4 KB, the top 2 KB hold the core 0 / ISR stack)
+// A hot stack in a scratch bank does not share a bank with DMA or the
+// other core, which the striped banks 0-3 always do.
+// TCBs and queue control blocks always go to BSS.
+
+// Cores (FREERTOS_SMP only, ignored otherwise): the samplers get core 1 to
+// themselves; everything that writes to stdio stays on core 0. Whole
+// frames are kept apart by xMutexTX (APP_MUTEXES), on any build.
+#define APP_CORE_0    (1u << 0)
+#define APP_CORE_1    (1u << 1)
+#define APP_CORE_ANY  (APP_CORE_0 | APP_CORE_1)
+
+// Timing (period, deadline, in us): period is the release interval, or the
+// minimum inter-arrival time for event-driven tasks; the deadline is
+// counted from the wake-up. Priorities are rate-monotonic, as assigned by
+// tools/rm_sched.py from these periods and the loop-body WCETs measured by
+// wcet.h (command 'W'); run `tools/rm_sched.py --check` after changing a
+// period or a body.
+//
+// id (xHandle<id>), entry, name, stack words, priority, cores, period,
+// deadline, parameter, placement
+#if APP_DUAL_CORE
+// Sampling, filtering and debounce run on core 1 (input.c).
+#define APP_INPUT_TASKS(ROW)
+#else
+#define APP_INPUT_TASKS(ROW) \
+    ROW(X,      x_task,          "X Task",     2048, 5, APP_CORE_1, INPUT_SAMPLE_US,     INPUT_SAMPLE_US, NULL,        NOINIT) \
+    ROW(Y,      y_task,          "Y Task",     2048, 5, APP_CORE_1, INPUT_SAMPLE_US,     INPUT_SAMPLE_US, NULL,        NOINIT) \
+    ROW(Dir,    direcional_task, "Dir Task",   2048, 4, APP_CORE_0, 50000,               50000,           NULL,        NOINIT) \
+    ROW(Botao,  botao_task,      "Botao Task", 2048, 4, APP_CORE_0, DEBOUNCE_MS * 1000,  10000,           NULL,        NOINIT)
+#endif
+
+// UART: one packet per sampler period from each of X and Y. Buzzer: a
+// shot beeps for 100 ms. Power: the toggle is locked out for 5 s.
+#define APP_TASKS(ROW) \
+    APP_INPUT_TASKS(ROW) \
+    ROW(UART,   uart_task,       "UART Task",  2048, 5, APP_CORE_0, INPUT_SAMPLE_US / 2, INPUT_SAMPLE_US, NULL,        NOINIT) \
+    ROW(Buzzer, buzzer_task,     "Buzzer",     1024, 3, APP_CORE_0, 150000,              150000,          NULL,        NOINIT) \
+    ROW(Power,  power_task,      "Power",      1024, 1, APP_CORE_0, 5000000,             200000,          NULL,        NOINIT) \
+    ROW(HUD,    hud_task,        "HUD",        1024, 2, APP_CORE_0, 1000000 / HUD_FPS,   1000000 / HUD_FPS, &hud_queues, NOINIT) \
+    ROW(Cmd,    cmd_task,        "Cmd",        1024, 3, APP_CORE_0, 100000,              100000,          NULL,        NOINIT)
+
+// id (xQueue<id>), length, item type, placement
+// Pings (cmd.h) ride in xQueueADC behind the samples; in dual-core mode
+// uart_task drains the core 1 ring first, then xQueuePing.
+#if APP_DUAL_CORE
+#define APP_INPUT_QUEUES(ROW) \
+    ROW(Ping,    4, adc_t,          NOINIT)
+#else
+#define APP_INPUT_QUEUES(ROW) \
+    ROW(ADC,    32, adc_t,          NOINIT)
+#endif
+
+#define APP_QUEUES(ROW) \
+    APP_INPUT_QUEUES(ROW)
+
+// id (xMsg<id>), capacity in bytes, placement. Variable-length records
+// written from ISRs (evpath.h).
+#if APP_DUAL_CORE
+#define APP_MESSAGE_BUFFERS(ROW)
+#else
+#define APP_MESSAGE_BUFFERS(ROW) \
+    ROW(Eventos, 256, NOINIT)
+#endif
+
+// id (xEvent<id>), event groups. One-bit signals between tasks are task
+// notifications (signals.h), not semaphores or queues.
+#define APP_EVENT_GROUPS(ROW) \
+    ROW(Mode)
+
+// id (xMutex<id>), mutexes (priority inheritance). TX: every writer of a
+// packet or command frame holds it for the whole frame (cmd.h), so a
+// higher priority writer cannot split one.
+#define APP_MUTEXES(ROW) \
+    ROW(TX)
+
+// Section names carry the object name so the linker map shows each one
+// on its own line (tools/ram_report.py).
+#define APP_PLACE_NOINIT(sym)    __attribute__((section(".uninitialized_data.app_" #sym)))
+#define APP_PLACE_BSS(sym)       __attribute__((section(".bss.app_" #sym)))
+#define APP_PLACE_SCRATCH_X(sym) __attribute__((section(".scratch_x.app_" #sym)))
+#define APP_PLACE_SCRATCH_Y(sym) __attribute__((section(".scratch_y.app_" #sym)))
+
+#define APP_TASK_HANDLE(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    static TaskHandle_t xHandle##id;
+#define APP_QUEUE_HANDLE(id, len, type, place) \
+    static QueueHandle_t xQueue##id;
+#define APP_MESSAGE_BUFFER_HANDLE(id, bytes, place) \
+    static MessageBufferHandle_t xMsg##id;
+// Index into app_wcet[] per row.
+#define APP_TASK_ENUM(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    APP_TASK_##id,
+enum { APP_TASKS(APP_TASK_ENUM) APP_TASK_COUNT };
+
+// Loop-body timing of every row (app_tasks.c): tasks bracket each
+// iteration with APP_WCET_BEGIN/END.
+extern WcetSlot_t app_wcet[APP_TASK_COUNT];
+#define APP_WCET(id)           (&app_wcet[APP_TASK_##id])
+#define APP_WCET_BEGIN(id)     vWcetBegin(APP_WCET(id))
+#define APP_WCET_END(id)       xWcetEnd(APP_WCET(id))
+#define APP_TASK_WCET_ATTACH(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    vWcetAttach(xHandle##id, APP_WCET(id));
+
+#define APP_EVENT_GROUP_HANDLE(id) \
+    static EventGroupHandle_t xEvent##id;
+#define APP_MUTEX_HANDLE(id) \
+    static SemaphoreHandle_t xMutex##id;
+
+#if configSUPPORT_STATIC_ALLOCATION
+
+#define APP_TASK_STORAGE(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    static StackType_t app_stack_##id[words] __attribute__((aligned(8))) APP_PLACE_##place(stack_##id); \
+    static StaticTask_t app_tcb_##id APP_PLACE_BSS(tcb_##id);
+#if FREERTOS_SMP
+#define APP_TASK_CREATE(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    xHandle##id = xTaskCreateStaticAffinitySet(fn, name, words, param, prio, app_stack_##id, &app_tcb_##id, cores);
+#else
+#define APP_TASK_CREATE(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    xHandle##id = xTaskCreateStatic(fn, name, words, param, prio, app_stack_##id, &app_tcb_##id);
+#endif
+
+#define APP_QUEUE_STORAGE(id, len, type, place) \
+    static uint8_t app_qstore_##id[(len) * sizeof(type)] __attribute__((aligned(4))) APP_PLACE_##place(qstore_##id); \
+    static StaticQueue_t app_queue_##id APP_PLACE_BSS(queue_##id);
+#define APP_QUEUE_CREATE(id, len, type, place) \
+    xQueue##id = xQueueCreateStatic(len, sizeof(type), app_qstore_##id, &app_queue_##id);
+
+// The kernel needs one byte more than the capacity.
+#define APP_MESSAGE_BUFFER_STORAGE(id, bytes, place) \
+    static uint8_t app_mbstore_##id[(bytes) + 1] APP_PLACE_##place(mbstore_##id); \
+    static StaticMessageBuffer_t app_msgbuf_##id APP_PLACE_BSS(msgbuf_##id);
+#define APP_MESSAGE_BUFFER_CREATE(id, bytes, place) \
+    xMsg##id = xMessageBufferCreateStatic(bytes, app_mbstore_##id, &app_msgbuf_##id);
+
+#define APP_EVENT_GROUP_STORAGE(id) \
+    static StaticEventGroup_t app_evgroup_##id APP_PLACE_BSS(evgroup_##id);
+#define APP_EVENT_GROUP_CREATE(id) \
+    xEvent##id = xEventGroupCreateStatic(&app_evgroup_##id);
+
+#define APP_MUTEX_STORAGE(id) \
+    static StaticSemaphore_t app_mutex_##id APP_PLACE_BSS(mutex_##id);
+#define APP_MUTEX_CREATE(id) \
+    xMutex##id = xSemaphoreCreateMutexStatic(&app_mutex_##id);
+
+#else
+
+#define APP_TASK_STORAGE(id, fn, name, words, prio, cores, period, deadline, param, place)
+#if FREERTOS_SMP
+#define APP_TASK_CREATE(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    xTaskCreateAffinitySet(fn, name, words, param, prio, cores, &xHandle##id);
+#else
+#define APP_TASK_CREATE(id, fn, name, words, prio, cores, period, deadline, param, place) \
+    xTaskCreate(fn, name, words, param, prio, &xHandle##id);
+#endif
+
+#define APP_QUEUE_STORAGE(id, len, type, place)
+#define APP_QUEUE_CREATE(id, len, type, place) \
+    xQueue##id = xQueueCreate(len, sizeof(type));
+
+#define APP_MESSAGE_BUFFER_STORAGE(id, bytes, place)
+#define APP_MESSAGE_BUFFER_CREATE(id, bytes, place) \
+    xMsg##id = xMessageBufferCreate(bytes);
+
+#define APP_EVENT_GROUP_STORAGE(id)
+#define APP_EVENT_GROUP_CREATE(id) \
+    xEvent##id = xEventGroupCreate();
+
+#define APP_MUTEX_STORAGE(id)
+#define APP_MUTEX_CREATE(id) \
+    xMutex##id = xSemaphoreCreateMutex();
+
+#endif
+
+#endif // APP_TASKS_H
@@ -0,0 +1,298 @@
+#include "cmd.h"
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include "pico/stdlib.h"
+
+#include "telemetry.h"
+#include "governor.h"
+#include "app_tasks.h"
+#include "params.h"
+#include "config_store.h"
+
+#if !FREERTOS_SMP
+#include "tickless.h"
+#endif
+
+#ifdef FREERTOS_HEAP_TLSF
+#include "heap_tlsf.h"
+#endif
+
+typedef enum { RX_HDR, RX_CMD, RX_LEN, RX_PAYLOAD, RX_FTR } rx_state_t;
+
+typedef struct {
+    rx_state_t state;
+    uint8_t cmd;
+    uint8_t len;
+    uint8_t n;
+    uint8_t payload[CMD_MAX_PAYLOAD];
+} cmd_rx_t;
+
+static TaskHandle_t xHandleCmd;
+
+static void chars_available(void *param) {
+    (void)param;
+    BaseType_t woken = pdFALSE;
+    if (xHandleCmd) vTaskNotifyGiveFromISR(xHandleCmd, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+    *p++ = v >> 24;
+    *p++ = v >> 16;
+    *p++ = v >> 8;
+    *p++ = v;
+    return p;
+}
+
+static uint32_t get_u32(const uint8_t *q) {
+    return ((uint32_t)q[0] << 24) | ((uint32_t)q[1] << 16) | ((uint32_t)q[2] << 8) | q[3];
+}
+
+// One frame at a time: uart_task (higher priority) waits for the end of
+// the frame instead of splitting it with a packet.
+static void cmd_reply(uint8_t cmd, const uint8_t *payload, uint8_t len) {
+    app_tx_begin();
+    putchar_raw(CMD_HDR);
+    putchar_raw(cmd);
+    putchar_raw(len);
+    for (uint8_t i = 0; i < len; i++) putchar_raw(payload[i]);
+    putchar_raw(CMD_FTR);
+    app_tx_end();
+}
+
+static void cmd_heap_stats(void) {
+    uint8_t out[24];
+    uint8_t len = 0;
+#ifdef FREERTOS_HEAP_TLSF
+    HeapTelemetry_t t;
+    vPortGetHeapTelemetry(&t);
+    uint8_t *p = out;
+    p = put_u32(p, t.xBytesInUse);
+    p = put_u32(p, t.xPeakBytesInUse);
+    p = put_u32(p, t.xFreeBytes);
+    p = put_u32(p, t.xLargestFreeBlock);
+    p = put_u32(p, t.xFreeBlocks);
+    p = put_u32(p, t.xFailedAllocations);
+    len = p - out;
+#endif
+    // Empty payload: the selected heap has no telemetry.
+    cmd_reply(CMD_HEAP_STATS, out, len);
+}
+
+static void cmd_bench_stats(void) {
+    uint8_t out[24];
+    uint8_t *p = out;
+    uint32_t frames = 0;
+    for (int i = 0; i < TELEM_SOURCES; i++) frames += telemetry.frames[i];
+    p = put_u32(p, telemetry.samples[TELEM_X]);
+    p = put_u32(p, frames);
+    p = put_u32(p, telemetry.period_min_us);
+    p = put_u32(p, telemetry.period_max_us);
+    p = put_u32(p, time_us_32());
+    p = put_u32(p, telemetry.boot_frame_us);
+    telemetry.period_reset = true;
+    cmd_reply(CMD_BENCH_STATS, out, p - out);
+}
+
+static void cmd_governor(void) {
+    uint8_t out[32];
+    uint8_t *p = out;
+    gov_state_t st = governor_state();
+    p = put_u32(p, st);
+    p = put_u32(p, st == GOV_FULL ? INPUT_SAMPLE_US : st == GOV_IDLE ? INPUT_IDLE_US : 0);
+    p = put_u32(p, telemetry.gov_wake_us);
+    p = put_u32(p, telemetry.gov_wake_max_us);
+#if !FREERTOS_SMP
+    TicklessStats_t t;
+    vPortGetTicklessStats(&t);
+    p = put_u32(p, t.ulSleeps);
+    p = put_u32(p, t.ulAborted);
+    p = put_u32(p, (uint32_t)(t.ullSleptUs / 1000));
+    p = put_u32(p, t.ulMaxSleepUs);
+#endif
+    // SMP builds use the kernel port's tickless idle, which keeps no stats.
+    cmd_reply(CMD_GOVERNOR, out, p - out);
+}
+
+// One frame per task table row; a non-zero payload byte clears the
+// figures after they are sent.
+static void cmd_wcet(const cmd_rx_t *rx) {
+    bool reset = rx->len >= 1 && rx->payload[0];
+    for (int i = 0; i < APP_TASK_COUNT; i++) {
+        WcetSlot_t *w = &app_wcet[i];
+        uint8_t out[CMD_MAX_PAYLOAD];
+        uint8_t *p = out;
+        uint8_t n = 0;
+        while (w->pcId[n] && n < CMD_WCET_ID_MAX) n++;
+        *p++ = i;
+        *p++ = n;
+        for (uint8_t k = 0; k < n; k++) *p++ = w->pcId[k];
+        p = put_u32(p, w->ulWcetUs);
+        p = put_u32(p, w->ulMaxResponseUs);
+        p = put_u32(p, w->ulRuns);
+        p = put_u32(p, w->ulMisses);
+        if (reset) vWcetReset(w);
+        cmd_reply(CMD_WCET, out, p - out);
+    }
+}
+
+// Back-to-back frames so the host can measure link throughput while the
+// samplers keep running.
+static void cmd_tx_burst(const cmd_rx_t *rx) {
+    if (rx->len < 2) return;
+    uint16_t count = (rx->payload[0] << 8) | rx->payload[1];
+    uint8_t out[CMD_TX_BURST_LEN] = {0};
+    for (uint32_t seq = 0; seq < count; seq++) {
+        put_u32(out, seq);
+        cmd_reply(CMD_TX_BURST, out, sizeof(out));
+    }
+}
+
+static void cmd_ping(const cmd_rx_t *rx) {
+    if (rx->len < 4) return;
+    app_post_ping(get_u32(rx->payload), time_us_32());
+}
+
+// Runs in uart_task, between two data frames.
+void cmd_ping_reply(uint32_t seq, uint32_t t_rx_us) {
+    uint8_t out[12];
+    uint8_t *p = out;
+    p = put_u32(p, seq);
+    p = put_u32(p, t_rx_us);
+    p = put_u32(p, time_us_32());
+    cmd_reply(CMD_PING, out, p - out);
+}
+
+static void cmd_param_schema(void) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        const param_info_t *pi = &param_info[i];
+        uint8_t out[CMD_MAX_PAYLOAD];
+        uint8_t *p = out;
+        uint8_t n = 0;
+        while (pi->name[n] && n < CMD_PARAM_NAME_MAX) n++;
+        *p++ = i;
+        *p++ = PARAM_COUNT;
+        p = put_u32(p, pi->def);
+        p = put_u32(p, pi->min);
+        p = put_u32(p, pi->max);
+        *p++ = n;
+        for (uint8_t k = 0; k < n; k++) *p++ = pi->name[k];
+        cmd_reply(CMD_PARAM_SCHEMA, out, p - out);
+    }
+}
+
+static void cmd_param_get_one(uint8_t id) {
+    uint8_t out[9];
+    uint8_t *p = out;
+    *p++ = id;
+    p = put_u32(p, params_live.v[id]);
+    p = put_u32(p, params_staged(id));
+    cmd_reply(CMD_PARAM_GET, out, p - out);
+}
+
+static void cmd_param_get(const cmd_rx_t *rx) {
+    if (rx->len >= 1) {
+        if (rx->payload[0] < PARAM_COUNT) cmd_param_get_one(rx->payload[0]);
+        return;
+    }
+    for (int i = 0; i < PARAM_COUNT; i++) cmd_param_get_one(i);
+}
+
+static void cmd_param_set(const cmd_rx_t *rx) {
+    if (rx->len < 5) return;
+    uint8_t id = rx->payload[0];
+    uint8_t out[6];
+    uint8_t *p = out;
+    *p++ = id;
+    *p++ = params_stage(id, (int32_t)get_u32(rx->payload + 1));
+    p = put_u32(p, params_staged(id));
+    cmd_reply(CMD_PARAM_SET, out, p - out);
+}
+
+static void cmd_param_apply(void) {
+    uint8_t out[4];
+    put_u32(out, params_apply());
+    cmd_reply(CMD_PARAM_APPLY, out, sizeof(out));
+}
+
+static void cmd_config(const cmd_rx_t *rx) {
+    uint8_t op = rx->len >= 1 ? rx->payload[0] : 0;
+    config_status_t st = CONFIG_OK;
+    if (op == 1) st = config_store_save();
+    else if (op == 2) st = config_store_wipe();
+    const config_stats_t *cs = config_store_stats();
+    uint8_t out[29];
+    uint8_t *p = out;
+    *p++ = st;
+    p = put_u32(p, cs->seq);
+    p = put_u32(p, cs->load_us);
+    p = put_u32(p, cs->scanned);
+    p = put_u32(p, cs->saves);
+    p = put_u32(p, cs->erases);
+    p = put_u32(p, cs->last_blocked_us);
+    p = put_u32(p, cs->max_blocked_us);
+    cmd_reply(CMD_CONFIG, out, p - out);
+}
+
+static void cmd_dispatch(const cmd_rx_t *rx) {
+    switch (rx->cmd) {
+    case CMD_HEAP_STATS: cmd_heap_stats(); break;
+    case CMD_BENCH_STATS: cmd_bench_stats(); break;
+    case CMD_TX_BURST: cmd_tx_burst(rx); break;
+    case CMD_GOVERNOR: cmd_governor(); break;
+    case CMD_WCET: cmd_wcet(rx); break;
+    case CMD_PING: cmd_ping(rx); break;
+    case CMD_PARAM_SCHEMA: cmd_param_schema(); break;
+    case CMD_PARAM_GET: cmd_param_get(rx); break;
+    case CMD_PARAM_SET: cmd_param_set(rx); break;
+    case CMD_PARAM_APPLY: cmd_param_apply(); break;
+    case CMD_CONFIG: cmd_config(rx); break;
+    default: break;
+    }
+}
+
+static void cmd_feed(cmd_rx_t *rx, uint8_t b) {
+    switch (rx->state) {
+    case RX_HDR:
+        if (b == CMD_HDR) rx->state = RX_CMD;
+        break;
+    case RX_CMD:
+        rx->cmd = b;
+        rx->state = RX_LEN;
+        break;
+    case RX_LEN:
+        if (b > CMD_MAX_PAYLOAD) { rx->state = RX_HDR; break; }
+        rx->len = b;
+        rx->n = 0;
+        rx->state = b ? RX_PAYLOAD : RX_FTR;
+        break;
+    case RX_PAYLOAD:
+        rx->payload[rx->n++] = b;
+        if (rx->n == rx->len) rx->state = RX_FTR;
+        break;
+    case RX_FTR:
+        if (b == CMD_FTR) cmd_dispatch(rx);
+        rx->state = (b == CMD_HDR) ? RX_CMD : RX_HDR;
+        break;
+    }
+}
+
+void cmd_task(void *p) {
+    (void)p;
+    cmd_rx_t rx = { .state = RX_HDR };
+
+    xHandleCmd = xTaskGetCurrentTaskHandle();
+    stdio_set_chars_available_callback(chars_available, NULL);
+
+    while (1) {
+        // The timeout covers stdio drivers without the RX callback, and
+        // gives the config log its erase-ahead when nothing is sampling.
+        if (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100))) config_store_maintain();
+        APP_WCET_BEGIN(Cmd);
+        int c;
+        while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+            cmd_feed(&rx, (uint8_t)c);
+        APP_WCET_END(Cmd);
+    }
+}
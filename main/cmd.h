@@ -0,0 +1,53 @@
+#ifndef CMD_H
+#define CMD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host -> device requests and device -> host replies share one frame:
+//   0xD0 <cmd> <len> <payload: len bytes> 0xDF
+// Multi-byte fields are big-endian, like the 0xA0 joystick value.
+#define CMD_HDR          0xD0
+#define CMD_FTR          0xDF
+#define CMD_MAX_PAYLOAD  32
+
+#define CMD_HEAP_STATS   'H'   // -> in_use, peak, free, largest_free, free_blocks, failed
+#define CMD_BENCH_STATS  'B'   // -> x_samples, frames, period_min_us, period_max_us, now_us,
+                               //    boot_frame_us (0 until the first HUD frame; resets the
+                               //    period window)
+#define CMD_TX_BURST     'T'   // u16 count -> count 'T' frames of CMD_TX_BURST_LEN bytes
+#define CMD_GOVERNOR     'G'   // -> state, period_us, wake_us, wake_max_us, tickless_sleeps,
+                               //    tickless_aborted, tickless_slept_ms, tickless_max_sleep_us
+#define CMD_WCET         'W'   // [u8 reset] -> one 'W' frame per task: u8 index, u8 id_len, id,
+                               //    wcet_us, max_response_us, runs, deadline_misses
+#define CMD_PING         'P'   // u32 seq -> seq, t_rx_us, t_tx_us (device clock); answered
+                               //    by uart_task behind the frames already queued
+#define CMD_PARAM_SCHEMA 'Q'   // -> one 'Q' frame per parameter: u8 id, u8 count, i32
+                               //    default, min, max, u8 name_len, name (params.h)
+#define CMD_PARAM_GET    'V'   // [u8 id] -> 'V' frames: u8 id, i32 live, i32 staged
+                               //    (no payload: every parameter)
+#define CMD_PARAM_SET    'S'   // u8 id, i32 value -> u8 id, u8 status (param_status_t),
+                               //    i32 staged; stages only
+#define CMD_PARAM_APPLY  'A'   // -> u32 seq; publishes every staged value at once, the
+                               //    input loops switch at their next sample cycle
+#define CMD_CONFIG       'C'   // [u8 op] -> u8 status (config_status_t), seq, load_us,
+                               //    scanned, saves, erases, last_blocked_us, max_blocked_us
+                               //    op: 0 stats, 1 save the live parameters, 2 wipe
+#define CMD_PARAM_NAME_MAX 16
+#define CMD_WCET_ID_MAX  10
+#define CMD_TX_BURST_LEN 16
+
+void cmd_task(void *p);
+
+// Ping path. cmd_task hands the probe to main.c, which queues it for
+// uart_task like a sample; uart_task then sends the reply with
+// cmd_ping_reply, so t_tx_us - t_rx_us is the time the probe spent
+// waiting behind real frames. False if the queue is full (no reply).
+bool app_post_ping(uint32_t seq, uint32_t t_rx_us);
+void cmd_ping_reply(uint32_t seq, uint32_t t_rx_us);
+
+// Held around every frame written to stdio (main.c), from any task.
+void app_tx_begin(void);
+void app_tx_end(void);
+
+#endif // CMD_H
@@ -0,0 +1,224 @@
+#include "config_store.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+#include "telemetry.h"
+
+#define CONFIG_MAGIC            0x47464350u     // "PCFG"
+#define CONFIG_REGION_SIZE      (CONFIG_SECTORS * FLASH_SECTOR_SIZE)
+#define CONFIG_REGION_OFFSET    (PICO_FLASH_SIZE_BYTES - CONFIG_REGION_SIZE)
+#define CONFIG_SLOTS_PER_SECTOR ((int)(FLASH_SECTOR_SIZE / CONFIG_RECORD_SIZE))
+#define CONFIG_SLOTS            (CONFIG_SECTORS * CONFIG_SLOTS_PER_SECTOR)
+#define CONFIG_FLASH_TIMEOUT_MS 100
+
+_Static_assert(PARAM_COUNT <= CONFIG_MAX_PARAMS, "config record too small for PARAMS");
+_Static_assert(FLASH_PAGE_SIZE % CONFIG_RECORD_SIZE == 0, "records must not straddle pages");
+
+typedef struct {
+    uint32_t magic;
+    uint16_t layout;
+    uint8_t count;
+    uint8_t reserved;
+    uint32_t seq;
+    int32_t v[CONFIG_MAX_PARAMS];
+    uint32_t crc;
+} config_record_t;
+
+_Static_assert(sizeof(config_record_t) == CONFIG_RECORD_SIZE, "config record layout");
+
+extern char __flash_binary_end;
+
+static config_stats_t stats;
+static int newest = -1;         // slot of the newest valid record
+static int next_slot;           // where the next save goes
+static bool region_ok;
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *data;        // NULL: erase a sector
+} flash_op_t;
+
+static uint32_t crc32(const void *p, size_t n) {
+    static const uint32_t nibble[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    const uint8_t *b = p;
+    uint32_t c = 0xffffffffu;
+    while (n--) {
+        c ^= *b++;
+        c = (c >> 4) ^ nibble[c & 15];
+        c = (c >> 4) ^ nibble[c & 15];
+    }
+    return ~c;
+}
+
+static const config_record_t *slot_ptr(int slot) {
+    return (const config_record_t *)(XIP_BASE + CONFIG_REGION_OFFSET + slot * CONFIG_RECORD_SIZE);
+}
+
+static bool blank(const void *p, size_t n) {
+    const uint32_t *w = p;
+    for (size_t i = 0; i < n / 4; i++)
+        if (w[i] != 0xffffffffu) return false;
+    return true;
+}
+
+static bool sector_blank(int sector) {
+    return blank(slot_ptr(sector * CONFIG_SLOTS_PER_SECTOR), FLASH_SECTOR_SIZE);
+}
+
+static bool header_valid(const config_record_t *r) {
+    return r->magic == CONFIG_MAGIC && r->layout == CONFIG_LAYOUT_VERSION &&
+           r->count <= CONFIG_MAX_PARAMS;
+}
+
+static bool crc_valid(const config_record_t *r) {
+    return r->crc == crc32(r, offsetof(config_record_t, crc));
+}
+
+// Runs with interrupts off and, under SMP, the other core parked: no
+// flash code and no kernel calls in here.
+static void __not_in_flash_func(flash_op)(void *param) {
+    const flash_op_t *op = param;
+    if (op->data) flash_range_program(op->offset, op->data, FLASH_PAGE_SIZE);
+    else flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+}
+
+static bool run_flash_op(flash_op_t *op) {
+    uint32_t t0 = time_us_32();
+    int rc = flash_safe_execute(flash_op, op, CONFIG_FLASH_TIMEOUT_MS);
+    uint32_t dt = time_us_32() - t0;
+    stats.last_blocked_us = dt;
+    if (dt > stats.max_blocked_us) stats.max_blocked_us = dt;
+    return rc == PICO_OK;
+}
+
+// A sector erase stops core 0 for tens of ms. On one core that is the
+// samplers, so only while ENABLE is off; core 1 samples from RAM.
+static bool erase_allowed(void) {
+#if APP_DUAL_CORE
+    return true;
+#else
+    return !telemetry.enabled;
+#endif
+}
+
+static bool erase_sector(int sector) {
+    flash_op_t op = { .offset = CONFIG_REGION_OFFSET + sector * FLASH_SECTOR_SIZE, .data = NULL };
+    if (!run_flash_op(&op)) return false;
+    stats.erases++;
+    return sector_blank(sector);
+}
+
+config_status_t config_store_load(void) {
+    uint32_t t0 = time_us_32();
+    region_ok = (uintptr_t)&__flash_binary_end <= XIP_BASE + CONFIG_REGION_OFFSET;
+    if (!region_ok) return CONFIG_NO_REGION;
+
+    // Newest header first; the CRC is only computed for that candidate
+    // (and the next one down if a torn write left it corrupt), which
+    // keeps the boot cost to one pass over the headers.
+    static uint32_t rejected[(CONFIG_SLOTS + 31) / 32];
+    for (;;) {
+        int best = -1;
+        uint32_t best_seq = 0;
+        stats.scanned = 0;
+        for (int slot = 0; slot < CONFIG_SLOTS; slot++) {
+            const config_record_t *r = slot_ptr(slot);
+            if (r->magic == 0xffffffffu && blank(r, CONFIG_RECORD_SIZE)) continue;
+            stats.scanned++;
+            if ((rejected[slot / 32] >> (slot % 32)) & 1 || !header_valid(r)) continue;
+            if (best < 0 || (int32_t)(r->seq - best_seq) > 0) {
+                best = slot;
+                best_seq = r->seq;
+            }
+        }
+        if (best < 0 || crc_valid(slot_ptr(best))) {
+            newest = best;
+            stats.seq = best < 0 ? 0 : best_seq;
+            break;
+        }
+        rejected[best / 32] |= 1u << (best % 32);
+    }
+    next_slot = newest < 0 ? 0 : (newest + 1) % CONFIG_SLOTS;
+
+    config_status_t st = CONFIG_EMPTY;
+    if (newest >= 0) {
+        const config_record_t *r = slot_ptr(newest);
+        for (int i = 0; i < r->count && i < PARAM_COUNT; i++)
+            params_stage(i, r->v[i]);
+        params_apply();
+        st = CONFIG_OK;
+    }
+    stats.load_us = time_us_32() - t0;
+    return st;
+}
+
+config_status_t config_store_save(void) {
+    if (!region_ok) return CONFIG_NO_REGION;
+
+    config_record_t rec;
+    memset(&rec, 0, sizeof rec);
+    rec.magic = CONFIG_MAGIC;
+    rec.layout = CONFIG_LAYOUT_VERSION;
+    rec.count = PARAM_COUNT;
+    rec.seq = stats.seq + 1;
+    for (int i = 0; i < PARAM_COUNT; i++) rec.v[i] = params_live.v[i];
+    rec.crc = crc32(&rec, offsetof(config_record_t, crc));
+
+    // Skip slots a torn write left dirty; entering a sector needs it blank.
+    for (int tries = 0; tries < CONFIG_SLOTS; tries++) {
+        int slot = next_slot;
+        int sector = slot / CONFIG_SLOTS_PER_SECTOR;
+        if (slot % CONFIG_SLOTS_PER_SECTOR == 0 && !sector_blank(sector)) {
+            if (newest >= 0 && newest / CONFIG_SLOTS_PER_SECTOR == sector) return CONFIG_FLASH_ERROR;
+            if (!erase_allowed()) return CONFIG_BUSY;
+            if (!erase_sector(sector)) return CONFIG_FLASH_ERROR;
+        }
+        next_slot = (slot + 1) % CONFIG_SLOTS;
+        if (!blank(slot_ptr(slot), CONFIG_RECORD_SIZE)) continue;
+
+        // Programming only clears bits, so the rest of the page stays as
+        // it is when written with 0xff.
+        static uint8_t page[FLASH_PAGE_SIZE] __attribute__((aligned(4)));
+        uint32_t offset = CONFIG_REGION_OFFSET + slot * CONFIG_RECORD_SIZE;
+        memset(page, 0xff, sizeof page);
+        memcpy(page + offset % FLASH_PAGE_SIZE, &rec, sizeof rec);
+        flash_op_t op = { .offset = offset - offset % FLASH_PAGE_SIZE, .data = page };
+        if (!run_flash_op(&op)) return CONFIG_FLASH_ERROR;
+        if (memcmp(slot_ptr(slot), &rec, sizeof rec)) continue;
+
+        newest = slot;
+        stats.seq = rec.seq;
+        stats.saves++;
+        return CONFIG_OK;
+    }
+    return CONFIG_FLASH_ERROR;
+}
+
+void config_store_maintain(void) {
+    if (!region_ok || !erase_allowed()) return;
+    int sector = next_slot / CONFIG_SLOTS_PER_SECTOR;
+    if (next_slot % CONFIG_SLOTS_PER_SECTOR) sector = (sector + 1) % CONFIG_SECTORS;
+    if (newest >= 0 && newest / CONFIG_SLOTS_PER_SECTOR == sector) return;
+    if (!sector_blank(sector)) erase_sector(sector);
+}
+
+config_status_t config_store_wipe(void) {
+    if (!region_ok) return CONFIG_NO_REGION;
+    if (!erase_allowed()) return CONFIG_BUSY;
+    for (int s = 0; s < CONFIG_SECTORS; s++)
+        if (!sector_blank(s) && !erase_sector(s)) return CONFIG_FLASH_ERROR;
+    newest = -1;
+    next_slot = 0;
+    return CONFIG_OK;
+}
+
+const config_stats_t *config_store_stats(void) {
+    return &stats;
+}
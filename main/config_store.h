@@ -0,0 +1,72 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "params.h"
+
+// Parameters (params.h) saved in the last CONFIG_SECTORS sectors of the
+// QSPI flash, as an append-only log of fixed-size records:
+//
+//   u32 magic, u16 layout, u8 count, u8 reserved, u32 seq,
+//   i32 v[CONFIG_MAX_PARAMS], u32 crc32 (over everything before it)
+//
+// A save writes the next slot; the newest valid record wins at boot.
+// The log wraps around the sectors, so each sector is erased once per
+// CONFIG_SECTORS * CONFIG_SLOTS_PER_SECTOR saves. A torn write fails the
+// CRC and the previous record stays in force. Parameter ids are stored by
+// position: only ever append rows to PARAMS. Records with fewer values
+// (older firmware) keep the defaults for the rest; values out of range
+// are ignored.
+//
+// While flash is being erased or programmed, nothing can run from it.
+//   APP_DUAL_CORE  the input engine on core 1 runs from RAM and keeps
+//                  sampling; only core 0 stops.
+//   otherwise      the samplers are core 0 tasks and wait. Programming a
+//                  slot takes under 1 ms; the sector erase (~50 ms) is
+//                  only done while ENABLE is off (config_store_maintain),
+//                  one sector ahead of the log, so a save never needs
+//                  one unless 64 saves were made in a single session.
+//   FREERTOS_SMP   flash_safe_execute parks the other core.
+// Without SMP core 1 is never parked: the build sets
+// PICO_FLASH_ASSUME_CORE1_SAFE, since core 1 is idle or runs from RAM.
+#define CONFIG_SECTORS           4
+#define CONFIG_RECORD_SIZE       64
+#define CONFIG_MAX_PARAMS        12
+#define CONFIG_LAYOUT_VERSION    1
+
+typedef enum {
+    CONFIG_OK = 0,
+    CONFIG_EMPTY,           // nothing saved yet (stats only)
+    CONFIG_BUSY,            // needs an erase while the samplers run
+    CONFIG_FLASH_ERROR,     // read-back mismatch
+    CONFIG_NO_REGION,       // the program overlaps the config sectors
+} config_status_t;
+
+typedef struct {
+    uint32_t seq;           // of the newest record, 0 if none
+    uint32_t load_us;       // boot: scan + apply
+    uint32_t scanned;       // non-empty slots seen at boot
+    uint32_t saves;
+    uint32_t erases;
+    uint32_t last_blocked_us;   // core 0 off flash for the last operation
+    uint32_t max_blocked_us;
+} config_stats_t;
+
+// At boot, after params_init and before the tasks start: applies the
+// newest saved record, if any.
+config_status_t config_store_load(void);
+
+// Saves the live parameter set (cmd_task).
+config_status_t config_store_save(void);
+
+// Erases the sector ahead of the log when that cannot stall sampling;
+// cheap when there is nothing to do (cmd_task, on its idle wake-ups).
+void config_store_maintain(void);
+
+// Erases every config sector; the defaults apply from the next boot.
+config_status_t config_store_wipe(void);
+
+const config_stats_t *config_store_stats(void);
+
+#endif // CONFIG_STORE_H
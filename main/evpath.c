@@ -0,0 +1,36 @@
+#include "evpath.h"
+
+#include <string.h>
+
+bool evpath_post_from_isr(MessageBufferHandle_t mb, uint8_t kind, uint32_t t_us,
+                          const void *data, uint8_t len, BaseType_t *woken) {
+    uint8_t rec[EVPATH_HDR_BYTES + EVPATH_MAX_DATA];
+    if (len > EVPATH_MAX_DATA) len = EVPATH_MAX_DATA;
+    rec[0] = kind;
+    rec[1] = t_us;
+    rec[2] = t_us >> 8;
+    rec[3] = t_us >> 16;
+    rec[4] = t_us >> 24;
+    memcpy(&rec[EVPATH_HDR_BYTES], data, len);
+    return xMessageBufferSendFromISR(mb, rec, EVPATH_HDR_BYTES + len, woken) != 0;
+}
+
+static bool evpath_decode(const uint8_t *rec, size_t n, ev_record_t *out) {
+    if (n < EVPATH_HDR_BYTES) return false;
+    out->kind = rec[0];
+    out->t_us = rec[1] | rec[2] << 8 | rec[3] << 16 | (uint32_t)rec[4] << 24;
+    out->len = n - EVPATH_HDR_BYTES;
+    memcpy(out->data, &rec[EVPATH_HDR_BYTES], out->len);
+    return true;
+}
+
+size_t evpath_drain(MessageBufferHandle_t mb, ev_record_t *out, size_t max, TickType_t wait) {
+    uint8_t rec[EVPATH_HDR_BYTES + EVPATH_MAX_DATA];
+    size_t count = 0;
+    while (count < max) {
+        size_t n = xMessageBufferReceive(mb, rec, sizeof(rec), count ? 0 : wait);
+        if (!n) break;
+        if (evpath_decode(rec, n, &out[count])) count++;
+    }
+    return count;
+}
@@ -0,0 +1,51 @@
+#ifndef EVPATH_H
+#define EVPATH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <FreeRTOS.h>
+#include <message_buffer.h>
+
+// Event path from interrupt handlers to a task over a message buffer.
+// Each record is variable-length:
+//
+//   <kind: u8> <t_us: u32 little-endian> <data: 0..EVPATH_MAX_DATA bytes>
+//
+// plus the one-byte length the kernel stores in front of every message
+// (configMESSAGE_BUFFER_LENGTH_TYPE). The timestamp is taken in the ISR,
+// so consumers see when the input happened, not when they got to it.
+//
+// A message buffer allows one writer at a time: post only from ISRs of
+// the same priority on the same core, or add a critical section.
+
+#define EVPATH_HDR_BYTES  5
+#define EVPATH_MAX_DATA   8
+
+typedef enum {
+    EV_GPIO = 1,        // data: ev_gpio_t
+} ev_kind_t;
+
+typedef struct {
+    uint8_t pin;
+    uint8_t events;     // GPIO_IRQ_EDGE_* mask from the callback
+} ev_gpio_t;
+
+#define EV_GPIO_RECORD_BYTES (1 + EVPATH_HDR_BYTES + sizeof(ev_gpio_t))
+
+typedef struct {
+    uint8_t kind;
+    uint8_t len;        // bytes used in data
+    uint32_t t_us;
+    uint8_t data[EVPATH_MAX_DATA];
+} ev_record_t;
+
+// False if the buffer is full (the record is dropped).
+bool evpath_post_from_isr(MessageBufferHandle_t mb, uint8_t kind, uint32_t t_us,
+                          const void *data, uint8_t len, BaseType_t *woken);
+
+// Waits up to `wait` for the first record, then takes the ones already
+// queued behind it, up to max. Returns the number of records in out.
+size_t evpath_drain(MessageBufferHandle_t mb, ev_record_t *out, size_t max, TickType_t wait);
+
+#endif // EVPATH_H
@@ -0,0 +1,74 @@
+#include "governor.h"
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include "pico/stdlib.h"
+
+#include "telemetry.h"
+
+static hrtimer_t *timers[GOVERNOR_TIMERS];
+static int n_timers;
+static gov_state_t state = GOV_OFF;
+static uint32_t last_activity_us;
+static uint32_t wake_from_us;
+static bool wake_pending;
+
+// Callers hold the critical section.
+static void governor_switch(gov_state_t to) {
+    state = to;
+    for (int i = 0; i < n_timers; i++) {
+        if (to == GOV_OFF) hrtimer_stop(timers[i]);
+        else hrtimer_retune(timers[i], to == GOV_FULL ? INPUT_SAMPLE_US : INPUT_IDLE_US);
+    }
+    // The jitter window in telemetry must not mix two rates.
+    telemetry.period_reset = true;
+    telemetry.gov_state = to;
+}
+
+void governor_register(hrtimer_t *t) {
+    UBaseType_t s = taskENTER_CRITICAL_FROM_ISR();
+    if (n_timers < GOVERNOR_TIMERS) {
+        timers[n_timers++] = t;
+        if (state != GOV_OFF)
+            hrtimer_retune(t, state == GOV_FULL ? INPUT_SAMPLE_US : INPUT_IDLE_US);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(s);
+}
+
+void governor_set_enabled(bool on) {
+    UBaseType_t s = taskENTER_CRITICAL_FROM_ISR();
+    last_activity_us = time_us_32();
+    wake_pending = false;
+    governor_switch(on ? GOV_FULL : GOV_OFF);
+    taskEXIT_CRITICAL_FROM_ISR(s);
+}
+
+void governor_activity(uint32_t now_us) {
+    UBaseType_t s = taskENTER_CRITICAL_FROM_ISR();
+    last_activity_us = now_us;
+    if (state == GOV_IDLE) {
+        wake_from_us = now_us;
+        wake_pending = true;
+        governor_switch(GOV_FULL);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(s);
+}
+
+void governor_sample(uint32_t now_us) {
+    UBaseType_t s = taskENTER_CRITICAL_FROM_ISR();
+    if (state == GOV_FULL) {
+        if (wake_pending) {
+            uint32_t lat = now_us - wake_from_us;
+            wake_pending = false;
+            telemetry.gov_wake_us = lat;
+            if (lat > telemetry.gov_wake_max_us) telemetry.gov_wake_max_us = lat;
+        } else if (now_us - last_activity_us >= GOVERNOR_IDLE_MS * 1000u) {
+            governor_switch(GOV_IDLE);
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(s);
+}
+
+gov_state_t governor_state(void) {
+    return state;
+}
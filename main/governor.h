@@ -0,0 +1,52 @@
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hrtimer.h"
+#include "input.h"
+
+// Sampling governor for the X/Y samplers. After GOVERNOR_IDLE_MS with the
+// stick in the dead zone and no button edge the sample timers drop to
+// INPUT_IDLE_HZ, so the idle task can stop the tick between samples. The
+// first movement or button edge switches them back to INPUT_SAMPLE_HZ at
+// once: the timers are retuned and fire immediately.
+//
+// Wake latency is measured from the event that ended the idle period to
+// the first full-rate sample. A stick movement is only seen by the next
+// idle-rate sample, so add up to one INPUT_IDLE_US to that figure.
+#ifndef INPUT_IDLE_HZ
+#define INPUT_IDLE_HZ       50
+#endif
+#define INPUT_IDLE_US       (1000000 / INPUT_IDLE_HZ)
+#ifndef GOVERNOR_IDLE_MS
+#define GOVERNOR_IDLE_MS   500
+#endif
+#define GOVERNOR_TIMERS      2
+
+#if INPUT_IDLE_HZ > INPUT_SAMPLE_HZ
+#error INPUT_IDLE_HZ must not exceed INPUT_SAMPLE_HZ
+#endif
+
+typedef enum {
+    GOV_OFF = 0,    // ENABLE off, timers stopped
+    GOV_IDLE,       // INPUT_IDLE_HZ
+    GOV_FULL,       // INPUT_SAMPLE_HZ
+} gov_state_t;
+
+// Adds a sampler's periodic timer; it is started at the current rate.
+void governor_register(hrtimer_t *t);
+
+// ENABLE on starts the timers at full rate, off stops them.
+void governor_set_enabled(bool on);
+
+// Movement or button edge. Safe from tasks and interrupts.
+void governor_activity(uint32_t now_us);
+
+// Called by the X sampler right after each read, before it looks at the
+// value; drops to the idle rate and records the wake latency.
+void governor_sample(uint32_t now_us);
+
+gov_state_t governor_state(void);
+
+#endif // GOVERNOR_H
@@ -0,0 +1,70 @@
+#include "hrtimer.h"
+
+#include "pico/stdlib.h"
+#include "hardware/timer.h"
+
+#define HRTIMER_ALARMS 4
+
+static hrtimer_t *owners[HRTIMER_ALARMS];
+
+static void hrtimer_isr(uint alarm) {
+    hrtimer_t *t = owners[alarm];
+    BaseType_t woken = pdFALSE;
+    if (!t) return;
+
+    vTaskNotifyGiveIndexedFromISR(t->task, HRTIMER_NOTIFY_INDEX, &woken);
+
+    if (t->period_us) {
+        // set_target returns true when the deadline has already passed.
+        t->deadline_us += t->period_us;
+        while (hardware_alarm_set_target(alarm, from_us_since_boot(t->deadline_us))) {
+            t->overruns++;
+            t->deadline_us += t->period_us;
+        }
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+bool hrtimer_init(hrtimer_t *t, TaskHandle_t task) {
+    t->alarm = hardware_alarm_claim_unused(false);
+    t->task = task;
+    t->period_us = 0;
+    t->overruns = 0;
+    if (t->alarm < 0) return false;
+    owners[t->alarm] = t;
+    hardware_alarm_set_callback(t->alarm, hrtimer_isr);
+    return true;
+}
+
+void hrtimer_start_oneshot(hrtimer_t *t, uint32_t delay_us) {
+    hardware_alarm_cancel(t->alarm);
+    t->period_us = 0;
+    t->deadline_us = time_us_64() + delay_us;
+    if (hardware_alarm_set_target(t->alarm, from_us_since_boot(t->deadline_us)))
+        hardware_alarm_force_irq(t->alarm);
+}
+
+void hrtimer_start_periodic(hrtimer_t *t, uint32_t period_us) {
+    hardware_alarm_cancel(t->alarm);
+    t->period_us = period_us;
+    t->deadline_us = time_us_64() + period_us;
+    if (hardware_alarm_set_target(t->alarm, from_us_since_boot(t->deadline_us)))
+        hardware_alarm_force_irq(t->alarm);
+}
+
+void hrtimer_retune(hrtimer_t *t, uint32_t period_us) {
+    hardware_alarm_cancel(t->alarm);
+    t->period_us = period_us;
+    t->deadline_us = time_us_64();
+    hardware_alarm_force_irq(t->alarm);
+}
+
+void hrtimer_stop(hrtimer_t *t) {
+    t->period_us = 0;
+    hardware_alarm_cancel(t->alarm);
+}
+
+uint32_t hrtimer_wait(hrtimer_t *t, TickType_t timeout) {
+    (void)t;
+    return ulTaskNotifyTakeIndexed(HRTIMER_NOTIFY_INDEX, pdTRUE, timeout);
+}
@@ -0,0 +1,43 @@
+#ifndef HRTIMER_H
+#define HRTIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <FreeRTOS.h>
+#include <task.h>
+
+// Microsecond timers on the RP2040 hardware alarms, independent of
+// configTICK_RATE_HZ. Each hrtimer_t owns one alarm (alarm 3 belongs to
+// the SDK alarm pool, so at most three are available) and wakes its task
+// with a direct-to-task notification on HRTIMER_NOTIFY_INDEX, leaving
+// index 0 to the rest of the application.
+//
+// Periodic timers are drift-free: every deadline is the previous deadline
+// plus the period, never "now + period". Deadlines that were already
+// missed are skipped and counted in overruns.
+
+#define HRTIMER_NOTIFY_INDEX 1
+
+typedef struct {
+    int alarm;                  // hardware alarm, -1 if none was free
+    TaskHandle_t task;
+    uint32_t period_us;         // 0 for one-shot
+    uint64_t deadline_us;
+    volatile uint32_t overruns;
+} hrtimer_t;
+
+// Claims an alarm for task; false if all alarms are taken.
+bool hrtimer_init(hrtimer_t *t, TaskHandle_t task);
+
+void hrtimer_start_oneshot(hrtimer_t *t, uint32_t delay_us);
+void hrtimer_start_periodic(hrtimer_t *t, uint32_t period_us);
+// Switches a periodic timer to period_us, firing once right away and then
+// every period_us from now. Call with interrupts masked.
+void hrtimer_retune(hrtimer_t *t, uint32_t period_us);
+void hrtimer_stop(hrtimer_t *t);
+
+// Blocks the owner task until the timer fires. Returns the number of
+// expiries since the last call (0 on timeout).
+uint32_t hrtimer_wait(hrtimer_t *t, TickType_t timeout);
+
+#endif // HRTIMER_H
@@ -0,0 +1,88 @@
+#include "hud.h"
+
+#include <task.h>
+#include "pico/stdlib.h"
+#include "gfx.h"
+#include "hud_draw.h"
+#include "telemetry.h"
+#include "input.h"
+#include "evpath.h"
+#include "app_tasks.h"
+
+static ssd1306_t disp;
+static gfx_glyph_cache_t font;
+static uint32_t font_bits[GFX_FONT_8X5_CACHE_WORDS];
+
+static uint32_t soma(const volatile uint32_t *v) {
+    uint32_t s = 0;
+    for (int i = 0; i < TELEM_SOURCES; i++) s += v[i];
+    return s;
+}
+
+void hud_task(void *p) {
+    const hud_queues_t *q = p;
+    (void)q;
+
+    gfx_init(&disp, GFX_MONO_LCD_WIDTH, GFX_MONO_LCD_HEIGHT);
+    gfx_glyph_cache_init(&font, 1, font_bits, GFX_FONT_8X5_CACHE_WORDS);
+    hud_draw_labels(&disp, &font);
+
+    // Bring-up was started by main() with ssd1306_init_async.
+    while (!ssd1306_init_done()) vTaskDelay(1);
+    gfx_show(&disp);
+    telemetry.boot_frame_us = time_us_32();
+
+    uint32_t last_us = time_us_32();
+    uint32_t last_idle = ulTaskGetIdleRunTimeCounter();
+    uint32_t last_samples = soma(telemetry.samples);
+    uint32_t last_frames = soma(telemetry.frames);
+    TickType_t wake = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(1000 / HUD_FPS));
+
+        uint32_t now = time_us_32();
+        uint32_t idle = ulTaskGetIdleRunTimeCounter();
+        uint32_t samples = soma(telemetry.samples);
+        uint32_t frames = soma(telemetry.frames);
+        uint32_t dt = now - last_us;
+        if (!dt) continue;
+        APP_WCET_BEGIN(HUD);
+
+        uint32_t sr = (uint64_t)(samples - last_samples) * 1000000u / dt;
+        uint32_t tx = (uint64_t)(frames - last_frames) * 1000000u / dt;
+        // Idle time is summed over all cores under SMP.
+        uint32_t idle_pct = (uint64_t)(idle - last_idle) * 100u /
+                            ((uint64_t)dt * configNUMBER_OF_CORES);
+        // Read and clear as one step, or a max recorded in between is lost.
+        taskENTER_CRITICAL();
+        uint32_t lat_max = telemetry.latency_max_us;
+        telemetry.latency_max_us = 0;
+        taskEXIT_CRITICAL();
+
+        hud_values_t v = {
+            .sr = sr, .tx = tx, .enabled = telemetry.enabled,
+#if APP_DUAL_CORE
+            // One ring carries every input event from core 1.
+            .qa = input_pending(), .qb = 0,
+#else
+            .qa = uxQueueMessagesWaiting(q->adc),
+            // Button records are all EV_GPIO, so bytes / record size.
+            .qb = xStreamBufferBytesAvailable(q->eventos) / EV_GPIO_RECORD_BYTES,
+#endif
+            .drops = soma(telemetry.drops),
+            .lat = telemetry.latency_us, .lat_max = lat_max,
+            .idle = idle_pct,
+            .gain = telemetry.gain, .zona_morta = telemetry.zona_morta,
+        };
+        // Only fields whose glyphs changed reach the panel (gfx_show_dirty).
+        hud_draw_fields(&disp, &font, &v);
+        gfx_show_dirty(&disp);
+
+        last_us = now;
+        last_idle = idle;
+        last_samples = samples;
+        last_frames = frames;
+        APP_WCET_END(HUD);
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <FreeRTOS.h>
+#include <queue.h>
+#include <message_buffer.h>
+
+#ifndef HUD_FPS
+#define HUD_FPS 4
+#endif
+
+typedef struct {
+    QueueHandle_t adc;
+    MessageBufferHandle_t eventos;
+} hud_queues_t;
+
+void hud_task(void *p);
+
+#endif // HUD_H
@@ -0,0 +1,32 @@
+#include "hud_draw.h"
+
+#define CELL(n) ((n) * 6)
+#define ROW(n)  ((n) * 8)
+
+void hud_draw_labels(ssd1306_t *disp, const gfx_glyph_cache_t *font) {
+    gfx_draw_string_cached(disp, font, CELL(0),  ROW(0), "SR");
+    gfx_draw_string_cached(disp, font, CELL(7),  ROW(0), "TX");
+    gfx_draw_string_cached(disp, font, CELL(0),  ROW(1), "QA");
+    gfx_draw_string_cached(disp, font, CELL(5),  ROW(1), "QB");
+    gfx_draw_string_cached(disp, font, CELL(10), ROW(1), "DROP");
+    gfx_draw_string_cached(disp, font, CELL(0),  ROW(2), "LAT");
+    gfx_draw_string_cached(disp, font, CELL(11), ROW(2), "MAX");
+    gfx_draw_string_cached(disp, font, CELL(0),  ROW(3), "IDLE");
+    gfx_draw_string_cached(disp, font, CELL(7),  ROW(3), "%");
+    gfx_draw_string_cached(disp, font, CELL(9),  ROW(3), "G");
+    gfx_draw_string_cached(disp, font, CELL(13), ROW(3), "Z");
+}
+
+void hud_draw_fields(ssd1306_t *disp, const gfx_glyph_cache_t *font, const hud_values_t *v) {
+    gfx_draw_uint_field(disp, font, CELL(2),  ROW(0), 4, v->sr);
+    gfx_draw_uint_field(disp, font, CELL(9),  ROW(0), 4, v->tx);
+    gfx_draw_field(disp, font, CELL(14), ROW(0), 3, v->enabled ? "ON" : "OFF");
+    gfx_draw_uint_field(disp, font, CELL(2),  ROW(1), 2, v->qa);
+    gfx_draw_uint_field(disp, font, CELL(7),  ROW(1), 2, v->qb);
+    gfx_draw_uint_field(disp, font, CELL(14), ROW(1), 5, v->drops);
+    gfx_draw_uint_field(disp, font, CELL(3),  ROW(2), 5, v->lat);
+    gfx_draw_uint_field(disp, font, CELL(14), ROW(2), 5, v->lat_max);
+    gfx_draw_uint_field(disp, font, CELL(4),  ROW(3), 3, v->idle > 100 ? 100 : v->idle);
+    gfx_draw_uint_field(disp, font, CELL(10), ROW(3), 2, v->gain);
+    gfx_draw_uint_field(disp, font, CELL(14), ROW(3), 4, v->zona_morta);
+}
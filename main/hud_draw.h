@@ -0,0 +1,28 @@
+#ifndef HUD_DRAW_H
+#define HUD_DRAW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gfx.h"
+
+// HUD layout, kept apart from hud_task so host/oled_sim renders the same
+// screen without the kernel. Four rows of 6x8 cells, labels followed by
+// fixed-width fields, so a 128x32 panel fits it all.
+
+typedef struct {
+    uint32_t sr, tx;        // samples and frames per second
+    bool enabled;
+    uint32_t qa, qb;        // ADC queue and button records waiting
+    uint32_t drops;
+    uint32_t lat, lat_max;  // sample-to-TX latency, us
+    uint32_t idle;          // idle %, 0..100
+    uint32_t gain, zona_morta;
+} hud_values_t;
+
+// Static text; drawn once, the fields never overwrite it.
+void hud_draw_labels(ssd1306_t *disp, const gfx_glyph_cache_t *font);
+
+// Redraws every field. Unchanged glyphs are left clean for gfx_show_dirty.
+void hud_draw_fields(ssd1306_t *disp, const gfx_glyph_cache_t *font, const hud_values_t *v);
+
+#endif // HUD_DRAW_H
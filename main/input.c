@@ -0,0 +1,242 @@
+#include "input.h"
+
+#include <stdlib.h>
+#include "pico/platform.h"
+#include "params.h"
+
+// The helpers below also run on core 1 (APP_DUAL_CORE), which keeps
+// sampling from RAM while core 0 writes the flash (config_store.h).
+int __not_in_flash_func(converter_adc_para_mouse)(const params_t *p, int leitura, bool *parado) {
+    int c = leitura - 2048;
+    int ganho = p->v[PARAM_GANHO];
+    if (abs(c) < p->v[PARAM_ZONA_MORTA]) {
+        *parado = true;
+        return 0;
+    }
+    *parado = false;
+    int r = c * ganho / 2048;
+    if (r > ganho)  return ganho;
+    if (r < -ganho) return -ganho;
+    return r;
+}
+
+void __not_in_flash_func(janela_fill)(janela_t *w, int v) {
+    for (int i = 0; i < JANELA_MAX; i++) w->buf[i] = v;
+    w->idx = 0;
+}
+
+int __not_in_flash_func(janela_push)(janela_t *w, int v, int n) {
+    w->buf[w->idx] = v;
+    w->idx = (w->idx + 1) % JANELA_MAX;
+    int sum = 0;
+    for (int i = 1; i <= n; i++) sum += w->buf[(w->idx + JANELA_MAX - i) % JANELA_MAX];
+    return sum / n;
+}
+
+int __not_in_flash_func(input_scale_delta)(int *acc, int d) {
+    *acc += d * INPUT_SAMPLE_US;
+    int out = *acc / INPUT_BASE_PERIOD_US;
+    *acc -= out * INPUT_BASE_PERIOD_US;
+    return out;
+}
+
+#if APP_DUAL_CORE
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/adc.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "telemetry.h"
+
+// Ring: core 1 only writes head, core 0 only writes tail. The acquire /
+// release pairs order the slot contents against the index updates.
+static input_event_t ring[INPUT_RING_SIZE];
+static volatile uint32_t ring_head;
+static volatile uint32_t ring_tail;
+
+static volatile bool engine_enabled;
+static TaskHandle_t engine_consumer;
+
+typedef struct {
+    uint8_t mux;
+    janela_t janela;
+    int acc;
+    bool parado;
+} input_axis_t;
+
+// Not const: core 1 reads it every tick, and const data lives in flash.
+static struct {
+    uint8_t pin;
+    uint8_t codigo;
+} botoes[] = {
+    {16, ' '}, {17, 'R'}, {18, 1}, {19, 2}, {20, 'E'},
+};
+
+static bool __not_in_flash_func(ring_push)(const input_event_t *ev) {
+    uint32_t head = ring_head;
+    if (head - __atomic_load_n(&ring_tail, __ATOMIC_ACQUIRE) == INPUT_RING_SIZE)
+        return false;
+    ring[head & (INPUT_RING_SIZE - 1)] = *ev;
+    __atomic_store_n(&ring_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool input_pop(input_event_t *ev) {
+    uint32_t tail = ring_tail;
+    if (__atomic_load_n(&ring_head, __ATOMIC_ACQUIRE) == tail)
+        return false;
+    *ev = ring[tail & (INPUT_RING_SIZE - 1)];
+    __atomic_store_n(&ring_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t input_pending(void) {
+    return ring_head - ring_tail;
+}
+
+// The SDK's busy_wait_* live in flash; the engine must not touch flash.
+static void __not_in_flash_func(spin_until)(uint32_t t_us) {
+    while ((int32_t)(time_us_32() - t_us) < 0) tight_loop_contents();
+}
+
+static int __not_in_flash_func(ler_mux)(uint8_t channel) {
+    gpio_put(11,  channel & 0x01);
+    gpio_put(12, (channel >> 1) & 0x01);
+    gpio_put(13, (channel >> 2) & 0x01);
+    spin_until(time_us_32() + MUX_SETTLE_US);
+    return adc_read();
+}
+
+static void __not_in_flash_func(axis_reset)(input_axis_t *a) {
+    janela_fill(&a->janela, ler_mux(a->mux));
+    a->acc = 0;
+    a->parado = true;
+}
+
+// Moving average + dead zone; returns true when the caller should emit.
+static bool __not_in_flash_func(axis_sample)(const params_t *p, input_axis_t *a, int *d) {
+    int media = janela_push(&a->janela, ler_mux(a->mux), p->v[PARAM_JANELA]);
+    bool par;
+    *d = converter_adc_para_mouse(p, media, &par);
+    bool emit = !par || par != a->parado;
+    a->parado = par;
+    return emit;
+}
+
+static bool __not_in_flash_func(emit)(input_kind_t kind, uint8_t id, int val,
+                                      uint32_t t_us, telem_source_t src) {
+    input_event_t ev = { .kind = kind, .id = id, .val = val, .t_us = t_us };
+    if (ring_push(&ev)) return true;
+    telemetry.drops[src]++;
+    return false;
+}
+
+// Everything reachable from here is in RAM: __not_in_flash_func, static
+// inline SDK register accessors, or always_inline helpers (params_sync,
+// telemetry_sample_period). Integer division comes from the RAM copy of
+// the divider (PICO_DIVIDER_IN_RAM). Data too: no const tables in the
+// loop (botoes is in .data). The local initializers below may be copied
+// from .rodata, but only once, at boot, before anything writes the flash.
+// A call or load from flash would stall core 1 whenever core 0 programs
+// or erases it.
+static void __not_in_flash_func(engine_main)(void) {
+    input_axis_t eixos[2] = { { .mux = 2 }, { .mux = 3 } };
+    input_axis_t dirs[2]  = { { .mux = 0 }, { .mux = 1 } };
+    uint32_t last_press[count_of(botoes)] = {0};
+    bool last_level[count_of(botoes)];
+    bool was_enabled = false;
+    uint32_t tick = 0;
+    uint32_t last_x_us = 0;
+    params_t params = PARAMS_DEFAULTS;
+
+    adc_select_input(1);
+    uint32_t next = time_us_32();
+
+    while (1) {
+        next += INPUT_TICK_US;
+        spin_until(next);
+
+        if (!engine_enabled) {
+            was_enabled = false;
+            continue;
+        }
+        if (!was_enabled) {
+            for (int i = 0; i < 2; i++) { axis_reset(&eixos[i]); axis_reset(&dirs[i]); }
+            for (uint i = 0; i < count_of(botoes); i++) last_level[i] = gpio_get(botoes[i].pin);
+            was_enabled = true;
+            tick = 0;
+        }
+
+        // New parameters take effect at a tick boundary, all together.
+        params_sync(&params);
+        bool pushed = false;
+        uint32_t now_us = time_us_32();
+        uint32_t now_ms = now_us / 1000;
+
+        for (uint i = 0; i < count_of(botoes); i++) {
+            bool level = gpio_get(botoes[i].pin);
+            bool fell = last_level[i] && !level;
+            last_level[i] = level;
+            if (!fell || now_ms - last_press[i] < (uint32_t)params.v[PARAM_DEBOUNCE_MS]) continue;
+            last_press[i] = now_ms;
+            telemetry.samples[TELEM_BOTAO]++;
+            pushed |= emit(INPUT_BUTTON, botoes[i].codigo, 1, now_us, TELEM_BOTAO);
+        }
+
+        if (tick % INPUT_AXIS_TICKS == 0) {
+            for (int i = 0; i < 2; i++) {
+                int d;
+                uint32_t t = time_us_32();
+                bool send = axis_sample(&params, &eixos[i], &d);
+                if (i == 0) telemetry_sample_period(&last_x_us, t);
+                telemetry.samples[i ? TELEM_Y : TELEM_X]++;
+                if (eixos[i].parado) eixos[i].acc = 0;
+                else if ((d = input_scale_delta(&eixos[i].acc, d)) == 0) send = false;
+                if (send) pushed |= emit(INPUT_AXIS, i, d, t, i ? TELEM_Y : TELEM_X);
+            }
+        }
+
+        if (tick % INPUT_DIR_TICKS == 0) {
+            for (int i = 0; i < 2; i++) {
+                int c;
+                uint32_t t = time_us_32();
+                if (axis_sample(&params, &dirs[i], &c) && c)
+                    pushed |= emit(INPUT_DIR, i, c < 0 ? 'A' : 'S', t, TELEM_DIR);
+            }
+            telemetry.samples[TELEM_DIR] += 2;
+        }
+
+        // Doorbell only; if the FIFO is full core 0 is already awake.
+        // Written directly: multicore_fifo_push_* are flash functions.
+        if (pushed && multicore_fifo_wready()) {
+            sio_hw->fifo_wr = 0;
+            __sev();
+        }
+        tick++;
+    }
+}
+
+static void doorbell_isr(void) {
+    BaseType_t woken = pdFALSE;
+    multicore_fifo_drain();
+    multicore_fifo_clear_irq();
+    vTaskNotifyGiveFromISR(engine_consumer, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void input_engine_start(TaskHandle_t consumer) {
+    engine_consumer = consumer;
+    multicore_launch_core1(engine_main);
+    // The launch handshake uses the FIFO, so the doorbell goes live after it.
+    multicore_fifo_drain();
+    irq_set_exclusive_handler(SIO_IRQ_PROC0, doorbell_isr);
+    irq_set_enabled(SIO_IRQ_PROC0, true);
+}
+
+void input_engine_set_enabled(bool enabled) {
+    engine_enabled = enabled;
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Boot values; params.h makes them tunable from the host.
+#define JANELA              3
+#define JANELA_MAX          8
+#define ZONA_MORTA        800
+#define GANHO              50
+#define DEBOUNCE_MS        50
+
+// X/Y sample rate. converter_adc_para_mouse returns a delta per
+// INPUT_BASE_PERIOD_US (the old 10 ms cadence); input_scale_delta spreads
+// it over the real period so cursor speed does not depend on the rate.
+#ifndef INPUT_SAMPLE_HZ
+#define INPUT_SAMPLE_HZ        500
+#endif
+#define INPUT_SAMPLE_US        (1000000 / INPUT_SAMPLE_HZ)
+#define INPUT_BASE_PERIOD_US   10000
+#define MUX_SETTLE_US          20
+
+#if INPUT_SAMPLE_HZ < 100 || INPUT_SAMPLE_HZ > 1000 || 1000000 % INPUT_SAMPLE_HZ
+#error INPUT_SAMPLE_HZ must divide 1 s evenly and be within 100..1000
+#endif
+
+struct params;
+
+int converter_adc_para_mouse(const struct params *p, int leitura, bool *parado);
+
+// Moving average over the last n samples (1..JANELA_MAX). The buffer
+// always keeps JANELA_MAX samples, so n can change between calls.
+typedef struct {
+    int buf[JANELA_MAX];
+    uint8_t idx;
+} janela_t;
+
+void janela_fill(janela_t *w, int v);
+int janela_push(janela_t *w, int v, int n);
+
+// acc carries the sub-count remainder between samples; clear it when the
+// stick returns to the dead zone.
+int input_scale_delta(int *acc, int d);
+
+#if APP_DUAL_CORE
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+// Core 1 input engine: samples the mux/ADC and polls the buttons on a
+// fixed 1 ms grid, filters and debounces, and hands finished events to
+// core 0 through a single-producer/single-consumer ring. Nothing on
+// core 0 (USB, OLED, buzzer, kernel ticks) can delay a sample.
+
+typedef enum {
+    INPUT_AXIS,     // id 0 = X, 1 = Y; val = mouse delta
+    INPUT_DIR,      // id 0 = horizontal, 1 = vertical; val = 'A' / 'S'
+    INPUT_BUTTON,   // id = button code, as in the 0xB0 packet
+} input_kind_t;
+
+typedef struct {
+    uint8_t  kind;
+    uint8_t  id;
+    int16_t  val;
+    uint32_t t_us;  // time of the sample that produced the event
+} input_event_t;
+
+#define INPUT_RING_SIZE   128   // power of two; holds a flash sector
+                                // erase (~50 ms) without core 0
+#define INPUT_TICK_US    1000
+#define INPUT_AXIS_TICKS   (INPUT_SAMPLE_US / INPUT_TICK_US)
+#define INPUT_DIR_TICKS    50   // WASD every 50 ms, as direcional_task did
+
+#if INPUT_SAMPLE_US % INPUT_TICK_US
+#error APP_DUAL_CORE samples X/Y on a 1 ms grid: INPUT_SAMPLE_HZ must divide 1000
+#endif
+
+// Launches core 1. consumer is notified (vTaskNotifyGiveFromISR) through
+// the inter-core FIFO whenever new events are in the ring.
+void input_engine_start(TaskHandle_t consumer);
+
+// Sampling stops while disabled; filters restart on the next enable.
+void input_engine_set_enabled(bool enabled);
+
+// Core 0 side of the ring.
+bool input_pop(input_event_t *ev);
+uint32_t input_pending(void);
+
+#endif
+
+#endif // INPUT_H
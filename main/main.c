@@ -1,80 +1,149 @@
 #include <FreeRTOS.h>
 #include <task.h>
 #include <queue.h>
-#include <semphr.h>
+#include <event_groups.h>
 #include <stdlib.h>    
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "hardware/adc.h"
 #include "hardware/gpio.h"
 #include <stdbool.h>
+#include "telemetry.h"
+#include "hud.h"
+#include "cmd.h"
+#include "input.h"
+#include "params.h"
+#include "config_store.h"
+#include "hrtimer.h"
+#include "governor.h"
+#include "signals.h"
+#include "evpath.h"
+#include "app_tasks.h"
+#include "ssd1306.h"
 
-#define JANELA              3
-#define ZONA_MORTA        800
 #define BUZZER_PIN         15
 #define ENABLE_BUTTON_PIN  14  
 #define LED_PIN             2  
-#define DEBOUNCE_MS        50  
+#define CAL_TIMEOUT_MS    100
+#define BOTAO_BATCH         8
 
 typedef struct {
     int axis;
     int val;
+    uint32_t t_us;
 } adc_t;
 
-typedef struct {
-    uint8_t codigo;
-    bool    pressionado;
-} botao_evento_t;
-
-static QueueHandle_t xQueueADC;
-static QueueHandle_t xQueueBotoes;
-static QueueHandle_t xQueueBuzzer;
-static SemaphoreHandle_t xSemEnable;
-
-static TaskHandle_t xHandleX;
-static TaskHandle_t xHandleY;
-static TaskHandle_t xHandleDir;
-static TaskHandle_t xHandleUART;
-static TaskHandle_t xHandleBotao;
-static TaskHandle_t xHandleBuzzer;
-static TaskHandle_t xHandlePower;
+// adc_t.axis of a ping: val = seq, t_us = when cmd_task received it.
+#define ADC_PING  -1
+
+APP_QUEUES(APP_QUEUE_HANDLE)
+APP_MESSAGE_BUFFERS(APP_MESSAGE_BUFFER_HANDLE)
+APP_EVENT_GROUPS(APP_EVENT_GROUP_HANDLE)
+APP_MUTEXES(APP_MUTEX_HANDLE)
+APP_TASKS(APP_TASK_HANDLE)
+
+telemetry_t telemetry;
 
 static void gpio_callback(uint gpio, uint32_t events);
 static void gerar_buzzer_tiro();
 static void buzzer_task(void* p);
-static int converter_adc_para_mouse(int leitura, bool *parado);
+#if !APP_DUAL_CORE
 static void select_mux_channel(uint8_t channel);
+static int ler_mux(uint8_t channel);
 static void x_task(void* p);
 static void y_task(void* p);
 static void direcional_task(void* p);
-static void uart_task(void* p);
 static void botao_task(void* p);
+#endif
+static void uart_task(void* p);
 static void power_task(void* p);
 
+APP_QUEUES(APP_QUEUE_STORAGE)
+APP_MESSAGE_BUFFERS(APP_MESSAGE_BUFFER_STORAGE)
+APP_EVENT_GROUPS(APP_EVENT_GROUP_STORAGE)
+APP_MUTEXES(APP_MUTEX_STORAGE)
+APP_TASKS(APP_TASK_STORAGE)
+
+void app_tx_begin(void) {
+    xSemaphoreTake(xMutexTX, portMAX_DELAY);
+}
+
+void app_tx_end(void) {
+    xSemaphoreGive(xMutexTX);
+}
+
+static void enviar_eixo(int axis, int val, uint32_t t_us) {
+    app_tx_begin();
+    putchar_raw(0xA0);
+    putchar_raw((uint8_t)axis);
+    putchar_raw((val >> 8) & 0xFF);
+    putchar_raw(val & 0xFF);
+    putchar_raw(0xFF);
+    app_tx_end();
+    telemetry.frames[axis == 0 ? TELEM_X : TELEM_Y]++;
+    uint32_t lat = time_us_32() - t_us;
+    telemetry.latency_us = lat;
+    // The HUD reads and clears the max; neither side may split the other.
+    taskENTER_CRITICAL();
+    if (lat > telemetry.latency_max_us) telemetry.latency_max_us = lat;
+    taskEXIT_CRITICAL();
+}
+
+static void enviar_direcional(uint8_t axis, uint8_t cmd) {
+    app_tx_begin();
+    putchar_raw(0xC0); putchar_raw(axis); putchar_raw(cmd); putchar_raw(0xCF);
+    app_tx_end();
+    telemetry.frames[TELEM_DIR]++;
+}
+
+static void enviar_botao(uint8_t codigo, bool pressionado) {
+    app_tx_begin();
+    putchar_raw(0xB0); putchar_raw(codigo); putchar_raw(pressionado?1:0); putchar_raw(0xFE);
+    app_tx_end();
+    telemetry.frames[TELEM_BOTAO]++;
+    if (codigo==1 && pressionado) xTaskNotifyGiveIndexed(xHandleBuzzer, SIG_NOTIFY_INDEX);
+}
+
+#if !APP_DUAL_CORE
 static void select_mux_channel(uint8_t channel) {
     gpio_put(11,  channel & 0x01);
     gpio_put(12, (channel >> 1) & 0x01);
     gpio_put(13, (channel >> 2) & 0x01);
-    vTaskDelay(pdMS_TO_TICKS(1)); 
+    busy_wait_us_32(MUX_SETTLE_US);
 }
 
+// The samplers share the mux and the ADC: no task switch between picking
+// a channel and reading it.
+static int ler_mux(uint8_t channel) {
+    vTaskSuspendAll();
+    select_mux_channel(channel);
+    adc_select_input(1);
+    int v = adc_read();
+    xTaskResumeAll();
+    return v;
+}
+#endif
+
 static void gpio_callback(uint gpio, uint32_t events) {
     BaseType_t woken = pdFALSE;
     if (!(events & GPIO_IRQ_EDGE_FALL)) return;
     if (gpio == ENABLE_BUTTON_PIN) {
-        xSemaphoreGiveFromISR(xSemEnable, &woken);
+        vTaskNotifyGiveIndexedFromISR(xHandlePower, SIG_NOTIFY_INDEX, &woken);
         portYIELD_FROM_ISR(woken);
         return;
     }
-    botao_evento_t ev;
-    if      (gpio == 16) { ev.codigo = ' '; ev.pressionado = true; }
-    else if (gpio == 17) { ev.codigo = 'R'; ev.pressionado = true; }
-    else if (gpio == 18) { ev.codigo = 1;   ev.pressionado = true; }
-    else if (gpio == 19) { ev.codigo = 2;   ev.pressionado = true; }
-    else if (gpio == 20) { ev.codigo = 'E'; ev.pressionado = true; }
-    else return;
-    xQueueSendFromISR(xQueueBotoes, &ev, &woken);
+#if !APP_DUAL_CORE
+    // Only pin, edge and time here; botao_task maps and debounces.
+    if (gpio < 16 || gpio > 20) return;
+    if (!(xEventGroupGetBitsFromISR(xEventMode) & MODE_ENABLED)) return;
+    uint32_t now = time_us_32();
+    governor_activity(now);
+    telemetry.samples[TELEM_BOTAO]++;
+    ev_gpio_t g = { .pin = (uint8_t)gpio, .events = (uint8_t)events };
+    if (!evpath_post_from_isr(xMsgEventos, EV_GPIO, now, &g, sizeof(g), &woken))
+        telemetry.drops[TELEM_BOTAO]++;
     portYIELD_FROM_ISR(woken);
+#endif
 }
 
 static void gerar_buzzer_tiro() {
@@ -85,173 +154,293 @@ static void gerar_buzzer_tiro() {
 
 static void buzzer_task(void *p) {
     (void)p;
-    uint8_t token;
     while (1) {
-        if (xQueueReceive(xQueueBuzzer, &token, portMAX_DELAY)) {
-            gerar_buzzer_tiro();
-        }
-    }
-}
-
-static int converter_adc_para_mouse(int leitura, bool *parado) {
-    int c = leitura - 2048;
-    if (abs(c) < ZONA_MORTA) {
-        *parado = true;
-        return 0;
+        // Counting: shots that arrive during a beep are not lost.
+        ulTaskNotifyTakeIndexed(SIG_NOTIFY_INDEX, pdFALSE, portMAX_DELAY);
+        APP_WCET_BEGIN(Buzzer);
+        gerar_buzzer_tiro();
+        APP_WCET_END(Buzzer);
     }
-    *parado = false;
-    int r = c * 50 / 2048;
-    if (r > 50)  return 50;
-    if (r < -50) return -50;
-    return r;
 }
 
+#if !APP_DUAL_CORE
 static void x_task(void *p) {
     (void)p;
     adc_gpio_init(27);
-    int buf[JANELA] = {0};
-    int idx = 0;
+    janela_t janela = {0};
+    params_t params = PARAMS_DEFAULTS;
+    int cal = 0;
     bool last_par = true;
-    for (int i = 0; i < JANELA; i++) {
-        select_mux_channel(2);
-        adc_select_input(1);
-        buf[i] = adc_read();
-        vTaskDelay(pdMS_TO_TICKS(10));
-    }
+    uint32_t last_us = 0;
+    int acc = 0;
+    hrtimer_t timer;
+    // Sample clock off the hardware alarms, not the 100 Hz tick.
+    // The governor starts it and picks the rate. Without an alarm the
+    // sampler would never run: stop here instead of sampling nothing.
+    if (!hrtimer_init(&timer, xTaskGetCurrentTaskHandle()))
+        panic("X Task: no free hardware alarm");
+    governor_register(&timer);
     while (1) {
-        select_mux_channel(2);
-        adc_select_input(1);
-        buf[idx] = adc_read();
-        idx = (idx + 1) % JANELA;
-        int sum = buf[0] + buf[1] + buf[2];
+        EventBits_t mode = mode_wait_any(xEventMode, MODE_RUNNING);
+        APP_WCET_BEGIN(X);
+        params_sync(&params);
+        int n = params.v[PARAM_JANELA];
+        int media = janela_push(&janela, ler_mux(2), n);
+        uint32_t now = time_us_32();
+        telemetry_sample_period(&last_us, now);
+        governor_sample(now);
+        telemetry.samples[TELEM_X]++;
+        if (mode & MODE_CALIBRATING) {
+            // Fill the window before the first packet of this session.
+            if (!(mode & MODE_CAL_X) && ++cal >= n) {
+                xEventGroupSetBits(xEventMode, MODE_CAL_X);
+                cal = 0;
+            }
+            last_par = true;
+            acc = 0;
+            APP_WCET_END(X);
+            hrtimer_wait(&timer, portMAX_DELAY);
+            continue;
+        }
         bool par;
-        int d = converter_adc_para_mouse(sum / JANELA, &par);
-        adc_t pkt = { .axis = 0, .val = d };
-        if (!par || par != last_par) xQueueSend(xQueueADC, &pkt, 0);
+        int d = converter_adc_para_mouse(&params, media, &par);
+        if (par) acc = 0;
+        else { governor_activity(now); d = input_scale_delta(&acc, d); }
+        adc_t pkt = { .axis = 0, .val = d, .t_us = time_us_32() };
+        if (((!par && d) || par != last_par) && xQueueSend(xQueueADC, &pkt, 0) != pdTRUE)
+            telemetry.drops[TELEM_X]++;
         last_par = par;
-        vTaskDelay(pdMS_TO_TICKS(10));
+        APP_WCET_END(X);
+        hrtimer_wait(&timer, portMAX_DELAY);
     }
 }
 
 static void y_task(void *p) {
     (void)p;
     adc_gpio_init(27);
-    int buf[JANELA] = {0};
-    int idx = 0;
+    janela_t janela = {0};
+    params_t params = PARAMS_DEFAULTS;
+    int cal = 0;
     bool last_par = true;
-    for (int i = 0; i < JANELA; i++) {
-        select_mux_channel(3);
-        adc_select_input(1);
-        buf[i] = adc_read();
-        vTaskDelay(pdMS_TO_TICKS(10));
-    }
+    int acc = 0;
+    hrtimer_t timer;
+    // Sample clock off the hardware alarms, not the 100 Hz tick.
+    // The governor starts it and picks the rate.
+    if (!hrtimer_init(&timer, xTaskGetCurrentTaskHandle()))
+        panic("Y Task: no free hardware alarm");
+    governor_register(&timer);
     while (1) {
-        select_mux_channel(3);
-        adc_select_input(1);
-        buf[idx] = adc_read();
-        idx = (idx + 1) % JANELA;
-        int sum = buf[0] + buf[1] + buf[2];
+        EventBits_t mode = mode_wait_any(xEventMode, MODE_RUNNING);
+        APP_WCET_BEGIN(Y);
+        params_sync(&params);
+        int n = params.v[PARAM_JANELA];
+        int media = janela_push(&janela, ler_mux(3), n);
+        telemetry.samples[TELEM_Y]++;
+        if (mode & MODE_CALIBRATING) {
+            if (!(mode & MODE_CAL_Y) && ++cal >= n) {
+                xEventGroupSetBits(xEventMode, MODE_CAL_Y);
+                cal = 0;
+            }
+            last_par = true;
+            acc = 0;
+            APP_WCET_END(Y);
+            hrtimer_wait(&timer, portMAX_DELAY);
+            continue;
+        }
         bool par;
-        int d = converter_adc_para_mouse(sum / JANELA, &par);
-        adc_t pkt = { .axis = 1, .val = d };
-        if (!par || par != last_par) xQueueSend(xQueueADC, &pkt, 0);
+        int d = converter_adc_para_mouse(&params, media, &par);
+        if (par) acc = 0;
+        else { governor_activity(time_us_32()); d = input_scale_delta(&acc, d); }
+        adc_t pkt = { .axis = 1, .val = d, .t_us = time_us_32() };
+        if (((!par && d) || par != last_par) && xQueueSend(xQueueADC, &pkt, 0) != pdTRUE)
+            telemetry.drops[TELEM_Y]++;
         last_par = par;
-        vTaskDelay(pdMS_TO_TICKS(10));
+        APP_WCET_END(Y);
+        hrtimer_wait(&timer, portMAX_DELAY);
     }
 }
 
 static void direcional_task(void *p) {
     (void)p;
     adc_gpio_init(27);
-    int bufh[JANELA] = {0}, idxh = 0;
-    int bufv[JANELA] = {0}, idxv = 0;
+    janela_t janh = {0}, janv = {0};
+    params_t params = PARAMS_DEFAULTS;
     bool ph = true, pv = true;
     while (1) {
-        select_mux_channel(0);
-        adc_select_input(1);
-        bufh[idxh] = adc_read(); idxh = (idxh + 1) % JANELA;
-        int mh = bufh[0] + bufh[1] + bufh[2];
-        bool new_ph; int ch = converter_adc_para_mouse(mh / JANELA, &new_ph);
+        mode_wait_any(xEventMode, MODE_ENABLED);
+        APP_WCET_BEGIN(Dir);
+        params_sync(&params);
+        int mh = janela_push(&janh, ler_mux(0), params.v[PARAM_JANELA]);
+        bool new_ph; int ch = converter_adc_para_mouse(&params, mh, &new_ph);
         if (!new_ph || new_ph != ph) {
             uint8_t cmd = ch < 0 ? 'A' : (ch > 0 ? 'S' : 0);
-            if (cmd) { putchar_raw(0xC0); putchar_raw(0); putchar_raw(cmd); putchar_raw(0xCF); }
+            if (cmd) enviar_direcional(0, cmd);
         }
         ph = new_ph;
-        select_mux_channel(1);
-        adc_select_input(1);
-        bufv[idxv] = adc_read(); idxv = (idxv + 1) % JANELA;
-        int mv = bufv[0] + bufv[1] + bufv[2];
-        bool new_pv; int cv = converter_adc_para_mouse(mv / JANELA, &new_pv);
+        int mv = janela_push(&janv, ler_mux(1), params.v[PARAM_JANELA]);
+        bool new_pv; int cv = converter_adc_para_mouse(&params, mv, &new_pv);
         if (!new_pv || new_pv != pv) {
             uint8_t cmd = cv < 0 ? 'A' : (cv > 0 ? 'S' : 0);
-            if (cmd) { putchar_raw(0xC0); putchar_raw(1); putchar_raw(cmd); putchar_raw(0xCF); }
+            if (cmd) enviar_direcional(1, cmd);
         }
         pv = new_pv;
+        if (!new_ph || !new_pv) governor_activity(time_us_32());
+        telemetry.samples[TELEM_DIR] += 2;
+        APP_WCET_END(Dir);
         vTaskDelay(pdMS_TO_TICKS(50));
     }
 }
 
+// Packets sampled before a disable are dropped by the consumers instead
+// of resetting the queues under the producers.
 static void uart_task(void *p) {
     (void)p;
     adc_t pkt;
     while (1) {
         if (xQueueReceive(xQueueADC, &pkt, portMAX_DELAY)) {
-            putchar_raw(0xA0);
-            putchar_raw((uint8_t)pkt.axis);
-            putchar_raw((pkt.val >> 8) & 0xFF);
-            putchar_raw(pkt.val & 0xFF);
-            putchar_raw(0xFF);
+            APP_WCET_BEGIN(UART);
+            if (pkt.axis == ADC_PING)
+                cmd_ping_reply((uint32_t)pkt.val, pkt.t_us);
+            else if (xEventGroupGetBits(xEventMode) & MODE_ENABLED)
+                enviar_eixo(pkt.axis, pkt.val, pkt.t_us);
+            APP_WCET_END(UART);
         }
     }
 }
 
+static uint8_t botao_codigo(uint8_t pin) {
+    switch (pin) {
+    case 16: return ' ';
+    case 17: return 'R';
+    case 18: return 1;
+    case 19: return 2;
+    case 20: return 'E';
+    default: return 0;
+    }
+}
+
+// Drains every record the ISR queued since the last wake-up; debounce
+// runs on the press times taken in the ISR.
 static void botao_task(void *p) {
     (void)p;
-    botao_evento_t ev;
+    ev_record_t evs[BOTAO_BATCH];
+    params_t params = PARAMS_DEFAULTS;
     uint32_t last_space=0, last_shift=0;
     while (1) {
-        if (xQueueReceive(xQueueBotoes, &ev, portMAX_DELAY)) {
-            uint32_t now = to_ms_since_boot(get_absolute_time());
-            if (ev.codigo==' ' && now-last_space<DEBOUNCE_MS) continue;
-            if (ev.codigo==2   && now-last_shift<DEBOUNCE_MS) continue;
-            if (ev.codigo==' ') last_space=now;
-            if (ev.codigo==2)   last_shift=now;
-            putchar_raw(0xB0); putchar_raw(ev.codigo); putchar_raw(ev.pressionado?1:0); putchar_raw(0xFE);
-            if (ev.codigo==1 && ev.pressionado) { uint8_t one=1; xQueueSend(xQueueBuzzer,&one,0); }
+        size_t n = evpath_drain(xMsgEventos, evs, BOTAO_BATCH, portMAX_DELAY);
+        APP_WCET_BEGIN(Botao);
+        params_sync(&params);
+        uint32_t debounce_us = (uint32_t)params.v[PARAM_DEBOUNCE_MS] * 1000u;
+        if (!(xEventGroupGetBits(xEventMode) & MODE_ENABLED)) n = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (evs[i].kind != EV_GPIO) continue;
+            const ev_gpio_t *g = (const ev_gpio_t *)evs[i].data;
+            uint8_t codigo = botao_codigo(g->pin);
+            bool pressionado = g->events & GPIO_IRQ_EDGE_FALL;
+            uint32_t t = evs[i].t_us;
+            if (codigo==' ' && t-last_space<debounce_us) continue;
+            if (codigo==2   && t-last_shift<debounce_us) continue;
+            if (codigo==' ') last_space=t;
+            if (codigo==2)   last_shift=t;
+            enviar_botao(codigo, pressionado);
+        }
+        APP_WCET_END(Botao);
+    }
+}
+#else
+// Core 1 already filtered and debounced; events sampled before a disable
+// are dropped here instead of resetting a queue.
+static void uart_task(void *p) {
+    (void)p;
+    input_event_t ev;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        APP_WCET_BEGIN(UART);
+        while (input_pop(&ev)) {
+            if (!(xEventGroupGetBits(xEventMode) & MODE_ENABLED)) continue;
+            if (ev.kind == INPUT_AXIS)        enviar_eixo(ev.id, ev.val, ev.t_us);
+            else if (ev.kind == INPUT_DIR)    enviar_direcional(ev.id, ev.val);
+            else                              enviar_botao(ev.id, true);
         }
+        adc_t ping;
+        while (xQueueReceive(xQueuePing, &ping, 0))
+            cmd_ping_reply((uint32_t)ping.val, ping.t_us);
+        APP_WCET_END(UART);
     }
 }
+#endif
+
+#if !APP_DUAL_CORE
+bool app_post_ping(uint32_t seq, uint32_t t_rx_us) {
+    adc_t pkt = { .axis = ADC_PING, .val = (int)seq, .t_us = t_rx_us };
+    return xQueueSend(xQueueADC, &pkt, 0) == pdTRUE;
+}
+#else
+bool app_post_ping(uint32_t seq, uint32_t t_rx_us) {
+    adc_t ping = { .axis = ADC_PING, .val = (int)seq, .t_us = t_rx_us };
+    if (xQueueSend(xQueuePing, &ping, 0) != pdTRUE) return false;
+    xTaskNotifyGive(xHandleUART);
+    return true;
+}
+#endif
 
 static void power_task(void *p) {
     (void)p;
     bool enabled=false;
     while (1) {
-        if (xSemaphoreTake(xSemEnable,portMAX_DELAY)==pdTRUE) {
-            static uint32_t last_toggle=0; uint32_t now=to_ms_since_boot(get_absolute_time());
-            if (now-last_toggle<5000) continue; last_toggle=now;
-            if (!enabled) {
-                gpio_put(LED_PIN,1);
-                xQueueReset(xQueueADC); xQueueReset(xQueueBotoes);
-                vTaskResume(xHandleX); vTaskResume(xHandleY); vTaskResume(xHandleDir);
-                vTaskResume(xHandleUART); vTaskResume(xHandleBotao);
-            } else {
-                gpio_put(LED_PIN,0);
-                vTaskSuspend(xHandleX); vTaskSuspend(xHandleY); vTaskSuspend(xHandleDir);
-                vTaskSuspend(xHandleUART); vTaskSuspend(xHandleBotao);
-                xQueueReset(xQueueADC); xQueueReset(xQueueBotoes);
-            }
-            enabled=!enabled;
+        ulTaskNotifyTakeIndexed(SIG_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+        static uint32_t last_toggle=0; uint32_t now=to_ms_since_boot(get_absolute_time());
+        if (now-last_toggle<5000) continue; last_toggle=now;
+        APP_WCET_BEGIN(Power);
+#if APP_DUAL_CORE
+        gpio_put(LED_PIN,!enabled);
+        input_engine_set_enabled(!enabled);
+        if (!enabled) xEventGroupSetBits(xEventMode, MODE_ENABLED);
+        else xEventGroupClearBits(xEventMode, MODE_ENABLED);
+#else
+        if (!enabled) {
+            // The samplers refill their filters before anything is sent.
+            xEventGroupClearBits(xEventMode, MODE_CAL_DONE);
+            xEventGroupSetBits(xEventMode, MODE_CALIBRATING);
+            governor_set_enabled(true);
+            xEventGroupWaitBits(xEventMode, MODE_CAL_DONE, pdFALSE, pdTRUE, pdMS_TO_TICKS(CAL_TIMEOUT_MS));
+            xEventGroupClearBits(xEventMode, MODE_CALIBRATING);
+            xEventGroupSetBits(xEventMode, MODE_ENABLED);
+            gpio_put(LED_PIN,1);
+        } else {
+            gpio_put(LED_PIN,0);
+            xEventGroupClearBits(xEventMode, MODE_ENABLED);
+            // Stop the sample alarms too. The samplers stay blocked in
+            // hrtimer_wait until ENABLE restarts the alarms, which fire
+            // at once; at most one sample already in flight runs and
+            // then parks in mode_wait_any.
+            governor_set_enabled(false);
         }
+#endif
+        enabled=!enabled;
+        telemetry.enabled=enabled;
+        APP_WCET_END(Power);
     }
 }
 
 int main() {
+    ssd1306_init_async();
     stdio_init_all();
     adc_init();
-    xQueueADC    = xQueueCreate(32, sizeof(adc_t));
-    xQueueBotoes = xQueueCreate(32, sizeof(botao_evento_t));
-    xQueueBuzzer = xQueueCreate(8,  sizeof(uint8_t));
-    xSemEnable   = xSemaphoreCreateBinary();
+    APP_QUEUES(APP_QUEUE_CREATE)
+    APP_MESSAGE_BUFFERS(APP_MESSAGE_BUFFER_CREATE)
+    APP_EVENT_GROUPS(APP_EVENT_GROUP_CREATE)
+    APP_MUTEXES(APP_MUTEX_CREATE)
+
+    params_init();
+    // Saved parameters replace the defaults before any task samples.
+    config_store_load();
+    telemetry.period_reset = true;
+    static hud_queues_t hud_queues;
+#if !APP_DUAL_CORE
+    hud_queues.adc = xQueueADC;
+    hud_queues.eventos = xMsgEventos;
+#endif
 
     gpio_init(LED_PIN);
     gpio_set_dir(LED_PIN, GPIO_OUT);
@@ -279,26 +468,22 @@ int main() {
         gpio_init(button_pins[i]);
         gpio_set_dir(button_pins[i], GPIO_IN);
         gpio_pull_up(button_pins[i]);
+#if !APP_DUAL_CORE
         gpio_set_irq_enabled(button_pins[i], GPIO_IRQ_EDGE_FALL, true);
+#endif
     }
 
     gpio_init(BUZZER_PIN);
     gpio_set_dir(BUZZER_PIN, GPIO_OUT);
     gpio_put(BUZZER_PIN, 0);
 
-    xTaskCreate(x_task,           "X Task",    2048, NULL, 1, &xHandleX);
-    xTaskCreate(y_task,           "Y Task",    2048, NULL, 1, &xHandleY);
-    xTaskCreate(direcional_task,  "Dir Task",  2048, NULL, 1, &xHandleDir);
-    xTaskCreate(uart_task,        "UART Task", 2048, NULL, 1, &xHandleUART);
-    xTaskCreate(botao_task,       "Botao Task",2048, NULL, 1, &xHandleBotao);
-    xTaskCreate(buzzer_task,      "Buzzer",    1024, NULL, 2, &xHandleBuzzer);
-    xTaskCreate(power_task,       "Power",     1024, NULL, 3, &xHandlePower);
-
-    vTaskSuspend(xHandleX);
-    vTaskSuspend(xHandleY);
-    vTaskSuspend(xHandleDir);
-    vTaskSuspend(xHandleUART);
-    vTaskSuspend(xHandleBotao);
+    APP_TASKS(APP_TASK_CREATE)
+    APP_TASKS(APP_TASK_WCET_ATTACH)
+
+#if APP_DUAL_CORE
+    adc_gpio_init(27);
+    input_engine_start(xHandleUART);
+#endif
 
     vTaskStartScheduler();
     while (1) tight_loop_contents();
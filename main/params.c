@@ -0,0 +1,40 @@
+#include "params.h"
+
+#include "telemetry.h"
+
+#define PARAM_INFO(id, name, def, min, max) { name, def, min, max },
+const param_info_t param_info[PARAM_COUNT] = { PARAMS(PARAM_INFO) };
+
+volatile uint32_t params_live_seq;
+params_t params_live;
+
+static int32_t staged[PARAM_COUNT];
+
+void params_init(void) {
+    for (int i = 0; i < PARAM_COUNT; i++) staged[i] = param_info[i].def;
+    params_apply();
+}
+
+param_status_t params_stage(uint8_t id, int32_t value) {
+    if (id >= PARAM_COUNT) return PARAM_BAD_ID;
+    if (value < param_info[id].min || value > param_info[id].max) return PARAM_OUT_OF_RANGE;
+    staged[id] = value;
+    return PARAM_OK;
+}
+
+int32_t params_staged(uint8_t id) {
+    return id < PARAM_COUNT ? staged[id] : 0;
+}
+
+uint32_t params_apply(void) {
+    uint32_t s = params_live_seq;
+    __atomic_store_n(&params_live_seq, s + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (int i = 0; i < PARAM_COUNT; i++)
+        __atomic_store_n(&params_live.v[i], staged[i], __ATOMIC_RELAXED);
+    __atomic_store_n(&params_live_seq, s + 2, __ATOMIC_RELEASE);
+
+    telemetry.gain = staged[PARAM_GANHO];
+    telemetry.zona_morta = staged[PARAM_ZONA_MORTA];
+    return s + 2;
+}
@@ -0,0 +1,80 @@
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "input.h"
+
+// Input tuning that the host can change at run time (cmd.h: 'Q', 'V',
+// 'S', 'A'). The input.h #defines are the boot values.
+//
+// id (PARAM_<id>), name sent in the schema, default, min, max
+#define PARAMS(ROW) \
+    ROW(ZONA_MORTA,  "zona_morta",  ZONA_MORTA,  0,   2047)      \
+    ROW(GANHO,       "ganho",       GANHO,       1,   99)        \
+    ROW(DEBOUNCE_MS, "debounce_ms", DEBOUNCE_MS, 0,   1000)      \
+    ROW(JANELA,      "janela",      JANELA,      1,   JANELA_MAX)
+
+#define PARAM_ENUM(id, name, def, min, max) PARAM_##id,
+enum { PARAMS(PARAM_ENUM) PARAM_COUNT };
+
+typedef enum {
+    PARAM_OK = 0,
+    PARAM_BAD_ID,
+    PARAM_OUT_OF_RANGE,
+} param_status_t;
+
+typedef struct params {
+    int32_t v[PARAM_COUNT];
+    uint32_t seq;           // params_live_seq this copy was taken at;
+                            // 0 (never published) for a fresh copy
+} params_t;
+
+// Initializer of a fresh copy: the defaults, so a loop whose first
+// params_sync lands mid-apply still has a usable set (janela >= 1).
+#define PARAM_DEFAULT(id, name, def, min, max) def,
+#define PARAMS_DEFAULTS { .v = { PARAMS(PARAM_DEFAULT) }, .seq = 0 }
+
+typedef struct {
+    const char *name;
+    int32_t def, min, max;
+} param_info_t;
+
+extern const param_info_t param_info[PARAM_COUNT];
+
+// The published set, under a seqlock: params_live_seq is odd while
+// params_apply copies, and even (never 0) otherwise.
+extern volatile uint32_t params_live_seq;
+extern params_t params_live;
+
+// Called by each input loop at the top of a sample cycle, so a cycle
+// never mixes two parameter sets. The fast path is one load. While an
+// apply is in progress the loop keeps the set it has and picks the new
+// one up next cycle: on one core the writer (cmd_task, lower priority)
+// cannot finish until the loop blocks, so waiting would deadlock.
+// Returns true when local changed. Always inlined, so core 1 runs it
+// from RAM with the rest of the input engine.
+static inline __attribute__((always_inline)) bool params_sync(params_t *local) {
+    uint32_t s = __atomic_load_n(&params_live_seq, __ATOMIC_ACQUIRE);
+    if (s == local->seq || (s & 1)) return false;
+    // Word loops rather than memcpy: core 1 runs this from RAM.
+    int32_t tmp[PARAM_COUNT];
+    for (int i = 0; i < PARAM_COUNT; i++)
+        tmp[i] = __atomic_load_n(&params_live.v[i], __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&params_live_seq, __ATOMIC_RELAXED) != s) return false;
+    for (int i = 0; i < PARAM_COUNT; i++) local->v[i] = tmp[i];
+    local->seq = s;
+    return true;
+}
+
+// Publishes the defaults; call once before the tasks start.
+void params_init(void);
+
+// Staging, cmd_task only. Nothing reaches the input loops until
+// params_apply publishes every staged value at once.
+param_status_t params_stage(uint8_t id, int32_t value);
+int32_t params_staged(uint8_t id);
+uint32_t params_apply(void);    // returns the new sequence number
+
+#endif // PARAMS_H
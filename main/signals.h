@@ -0,0 +1,36 @@
+#ifndef SIGNALS_H
+#define SIGNALS_H
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <event_groups.h>
+
+// Signalling between tasks without queues or semaphores.
+//
+// Task notification indices (configTASK_NOTIFICATION_ARRAY_ENTRIES = 3):
+//   0                     doorbells: cmd_task RX, uart_task in dual-core mode
+//   HRTIMER_NOTIFY_INDEX  sample timers (hrtimer.h)
+//   SIG_NOTIFY_INDEX      one-bit signals below, used as counting
+//                         semaphores with xTaskNotifyGiveIndexed
+//
+// Global mode lives in one event group (xEventMode in main.c). Tasks
+// block on its bits instead of being suspended by power_task, so a
+// toggle never cuts a task off in the middle of a sample or a packet.
+#define SIG_NOTIFY_INDEX    2
+
+#define MODE_ENABLED        (1u << 0)   // samplers run and packets go out
+#define MODE_CALIBRATING    (1u << 1)   // samplers refill their filters, nothing is sent
+#define MODE_CAL_X          (1u << 2)   // set by x_task when its filter is full
+#define MODE_CAL_Y          (1u << 3)   // set by y_task
+#define MODE_CAL_DONE       (MODE_CAL_X | MODE_CAL_Y)
+#define MODE_RUNNING        (MODE_ENABLED | MODE_CALIBRATING)
+
+// Returns the mode bits once any of `bits` is set; the fast path is one
+// read of the group.
+static inline EventBits_t mode_wait_any(EventGroupHandle_t mode, EventBits_t bits) {
+    EventBits_t now = xEventGroupGetBits(mode);
+    if (now & bits) return now;
+    return xEventGroupWaitBits(mode, bits, pdFALSE, pdFALSE, portMAX_DELAY);
+}
+
+#endif // SIGNALS_H
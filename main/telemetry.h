@@ -0,0 +1,53 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// One slot per producer, so every counter has a single writer and can be
+// bumped without a critical section.
+typedef enum {
+    TELEM_X = 0,
+    TELEM_Y,
+    TELEM_DIR,
+    TELEM_BOTAO,
+    TELEM_SOURCES
+} telem_source_t;
+
+typedef struct {
+    volatile uint32_t samples[TELEM_SOURCES]; /**< ADC reads / button edges */
+    volatile uint32_t frames[TELEM_SOURCES];  /**< packets written to stdio */
+    volatile uint32_t drops[TELEM_SOURCES];   /**< events lost to a full queue */
+    volatile uint32_t latency_us;     /**< last sample-to-TX latency */
+    volatile uint32_t latency_max_us; /**< worst latency, cleared by the HUD */
+    volatile uint32_t boot_frame_us;  /**< boot to first HUD frame (command 'B') */
+    volatile uint32_t period_min_us;  /**< X sampler period, since the last reset */
+    volatile uint32_t period_max_us;
+    volatile bool period_reset;       /**< set by a reader, cleared by the sampler */
+    volatile uint8_t gov_state;       /**< gov_state_t, written by governor.c */
+    volatile uint32_t gov_wake_us;    /**< last idle -> full rate wake latency */
+    volatile uint32_t gov_wake_max_us;
+    volatile bool enabled;
+    volatile int gain;
+    volatile int zona_morta;
+} telemetry_t;
+
+extern telemetry_t telemetry;
+
+// Called by the X sampler with the time of each ADC read; the spread
+// between min and max period is the sampling jitter. Always inlined:
+// core 1 calls it from RAM (input.c).
+static inline __attribute__((always_inline)) void telemetry_sample_period(uint32_t *last_us, uint32_t now_us) {
+    uint32_t dt = now_us - *last_us;
+    *last_us = now_us;
+    if (telemetry.period_reset) {
+        telemetry.period_min_us = UINT32_MAX;
+        telemetry.period_max_us = 0;
+        telemetry.period_reset = false;
+        return;
+    }
+    if (dt < telemetry.period_min_us) telemetry.period_min_us = dt;
+    if (dt > telemetry.period_max_us) telemetry.period_max_us = dt;
+}
+
+#endif // TELEMETRY_H
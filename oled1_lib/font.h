@@ -1,7 +1,7 @@
 #ifndef _inc_font
 #define _inc_font
 
-#include "pico/stdlib.h"
+#include <stdint.h>
 
 /*
  * Format
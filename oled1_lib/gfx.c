@@ -1,6 +1,18 @@
 #include "gfx.h"
 #include "font.h"
 
+inline static void gfx_mark_dirty(ssd1306_t *p, uint32_t page, uint32_t x) {
+    if (x < p->dirty_lo[page])
+        p->dirty_lo[page] = x;
+    if (x > p->dirty_hi[page] || p->dirty_hi[page] < p->dirty_lo[page])
+        p->dirty_hi[page] = x;
+}
+
+inline static void gfx_mark_clean(ssd1306_t *p) {
+    memset(p->dirty_lo, 0xFF, sizeof(p->dirty_lo));
+    memset(p->dirty_hi, 0, sizeof(p->dirty_hi));
+}
+
 inline static void swap(int32_t *a, int32_t *b) {
     int32_t *t = a;
     *a = *b;
@@ -8,28 +20,34 @@ inline static void swap(int32_t *a, int32_t *b) {
 }
 
 char gfx_init(ssd1306_t *p, uint16_t width, uint16_t height) {
-    p->width = width;
-    p->height = height;
-    p->pages = height / 8;
-    p->bufsize = (p->pages) * (p->width);
-
-    // trocar remover malloc por alocação estática
-    if ((p->buffer = malloc(p->bufsize + 1)) == NULL) {
+    // Storage is sized for the build geometry (GFX_MONO_LCD_*); smaller
+    // panels fit, bigger ones need a rebuild.
+    if (width > GFX_MONO_LCD_WIDTH || height > GFX_MONO_LCD_HEIGHT ||
+        (height & 7)) {
         p->bufsize = 0;
         return false;
     }
 
-    memset(p->buffer, 0, p->bufsize + 1);
+    p->width = width;
+    p->height = height;
+    p->pages = height / 8;
+    p->bufsize = (p->pages) * (p->width);
+    p->buffer = (uint8_t *)p->fb;
 
-    ++(p->buffer);
+    gfx_clear_buffer(p);
 
     return true;
 }
 
-inline void gfx_deinit(ssd1306_t *p) { free(p->buffer - 1); }
-
 void gfx_clear_buffer(ssd1306_t *p) {
-    memset(p->buffer, 0, p->bufsize + 1);
+    uint32_t *w = p->fb;
+    for (size_t n = (p->bufsize + 3) / sizeof(uint32_t); n; --n)
+        *w++ = 0;
+
+    for (uint8_t page = 0; page < p->pages; page++) {
+        p->dirty_lo[page] = 0;
+        p->dirty_hi[page] = p->width - 1;
+    }
 }
 
 void gfx_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
@@ -37,6 +55,7 @@ void gfx_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
         return;
 
     p->buffer[x + p->width * (y >> 3)] &= ~(0x1 << (y & 0x07));
+    gfx_mark_dirty(p, y >> 3, x);
 }
 
 void gfx_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
@@ -45,6 +64,7 @@ void gfx_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
 
     p->buffer[x + p->width * (y >> 3)] |=
         0x1 << (y & 0x07); // y>>3==y/8 && y&0x7==y%8
+    gfx_mark_dirty(p, y >> 3, x);
 }
 
 void gfx_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2,
@@ -126,10 +146,138 @@ void gfx_draw_string(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale,
     gfx_draw_string_with_font(p, x, y, scale, font_8x5, s);
 }
 
+bool gfx_glyph_cache_init_with_font(gfx_glyph_cache_t *c, const uint8_t *font,
+                                    uint8_t scale, uint32_t *storage,
+                                    size_t words) {
+    if (scale == 0 || font[0] * scale > GFX_GLYPH_CACHE_MAX_HEIGHT)
+        return false;
+
+    uint32_t glyphs = font[4] - font[3] + 1;
+    if (words < GFX_GLYPH_CACHE_WORDS(glyphs, font[1]))
+        return false;
+
+    c->font = font;
+    c->scale = scale;
+    c->first = font[3];
+    c->last = font[4];
+    c->columns = font[1];
+    c->height = font[0] * scale;
+    c->advance = (font[1] + font[2]) * scale;
+    c->bits = storage;
+
+    uint32_t parts_per_line = (font[0] >> 3) + ((font[0] & 7) > 0);
+    const uint8_t *src = font + 5;
+    uint32_t *dst = storage;
+
+    for (uint32_t g = 0; g < glyphs; ++g) {
+        for (uint8_t w = 0; w < font[1]; ++w) {
+            uint32_t col = 0;
+            for (uint32_t lp = 0; lp < parts_per_line; ++lp) {
+                uint8_t line = *src++;
+                for (uint32_t j = 0; j < 8; ++j, line >>= 1) {
+                    uint32_t row = (lp << 3) + j;
+                    if ((line & 1) && row < font[0])
+                        col |= ((1u << scale) - 1) << (row * scale);
+                }
+            }
+            *dst++ = col;
+        }
+    }
+
+    return true;
+}
+
+bool gfx_glyph_cache_init(gfx_glyph_cache_t *c, uint8_t scale,
+                          uint32_t *storage, size_t words) {
+    return gfx_glyph_cache_init_with_font(c, font_8x5, scale, storage, words);
+}
+
+// Writes one column of up to 32 pixels starting at row y. Pixels inside
+// mask are replaced by bits, everything else in the page bytes is kept.
+static void gfx_blit_column(ssd1306_t *p, uint32_t x, uint32_t y,
+                            uint32_t bits, uint32_t mask) {
+    if (x >= p->width)
+        return;
+
+    uint64_t b = (uint64_t)bits << (y & 7);
+    uint64_t m = (uint64_t)mask << (y & 7);
+    uint8_t *dst = p->buffer + x + p->width * (y >> 3);
+
+    for (uint32_t page = y >> 3; m && page < p->pages; ++page) {
+        uint8_t v = (*dst & ~(uint8_t)m) | (uint8_t)b;
+        if (v != *dst) {
+            *dst = v;
+            gfx_mark_dirty(p, page, x);
+        }
+        dst += p->width;
+        b >>= 8;
+        m >>= 8;
+    }
+}
+
+static void gfx_blit_glyph(ssd1306_t *p, const gfx_glyph_cache_t *c,
+                           uint32_t x, uint32_t y, char ch, uint32_t mask) {
+    const uint32_t *cols = NULL;
+    if (ch >= c->first && ch <= c->last)
+        cols = c->bits + (uint32_t)(ch - c->first) * c->columns;
+
+    uint32_t width = mask ? c->advance : (uint32_t)c->columns * c->scale;
+    for (uint32_t i = 0; i < width; ++i) {
+        uint32_t w = i / c->scale;
+        uint32_t bits = (cols && w < c->columns) ? cols[w] : 0;
+        if (bits || mask)
+            gfx_blit_column(p, x + i, y, bits, mask | bits);
+    }
+}
+
+void gfx_draw_string_cached(ssd1306_t *p, const gfx_glyph_cache_t *c,
+                            uint32_t x, uint32_t y, const char *s) {
+    for (; *s && x < p->width; x += c->advance)
+        gfx_blit_glyph(p, c, x, y, *(s++), 0);
+}
+
+void gfx_draw_field(ssd1306_t *p, const gfx_glyph_cache_t *c, uint32_t x,
+                    uint32_t y, uint8_t cells, const char *s) {
+    uint32_t mask = c->height >= 32 ? 0xFFFFFFFFu : (1u << c->height) - 1;
+
+    for (uint8_t i = 0; i < cells; ++i, x += c->advance)
+        gfx_blit_glyph(p, c, x, y, *s ? *(s++) : ' ', mask);
+}
+
+void gfx_draw_uint_field(ssd1306_t *p, const gfx_glyph_cache_t *c,
+                         uint32_t x, uint32_t y, uint8_t digits,
+                         uint32_t value) {
+    char text[11];
+
+    if (digits > sizeof(text) - 1)
+        digits = sizeof(text) - 1;
+    text[digits] = '\0';
+
+    // Right aligned, leading blanks; saturates at all nines.
+    for (int i = digits - 1; i >= 0; --i) {
+        text[i] = (value || i == digits - 1) ? '0' + value % 10 : ' ';
+        value /= 10;
+    }
+    if (value)
+        memset(text, '9', digits);
+
+    gfx_draw_field(p, c, x, y, digits, text);
+}
+
 void gfx_show(ssd1306_t *p) {
+    for (uint8_t page = 0; page < p->pages; page++)
+        ssd1306_put_span(p->buffer + (page * p->width), page, 0, p->width);
+
+    gfx_mark_clean(p);
+}
+
+void gfx_show_dirty(ssd1306_t *p) {
     for (uint8_t page = 0; page < p->pages; page++) {
-        ssd1306_set_page_address(page);
-        ssd1306_set_column_address(0);
-        ssd1306_put_page(p->buffer + (page * p->width), page, 0, p->width);
+        uint8_t lo = p->dirty_lo[page], hi = p->dirty_hi[page];
+        if (hi >= lo && lo < p->width)
+            ssd1306_put_span(p->buffer + (page * p->width) + lo, page, lo,
+                             hi - lo + 1);
     }
+
+    gfx_mark_clean(p);
 }
@@ -9,13 +9,38 @@ typedef struct {
     uint8_t height;    /**< height of display */
     uint8_t pages;     /**< stores pages of display (calculated on initialization*/
     bool external_vcc; /**< whether display uses external vcc */
-    uint8_t *buffer;   /**< display buffer */
+    uint8_t *buffer;   /**< display buffer, points into fb */
     size_t bufsize;    /**< buffer size */
+    uint32_t fb[GFX_MONO_LCD_FRAMEBUFFER_SIZE / sizeof(uint32_t)]; /**< word aligned storage, sized for the build geometry */
+    uint8_t dirty_lo[GFX_MONO_LCD_PAGES]; /**< first changed column per page */
+    uint8_t dirty_hi[GFX_MONO_LCD_PAGES]; /**< last changed column per page, below dirty_lo when clean */
 } ssd1306_t;
 
+/*
+ * Glyphs pre-expanded to one word per font column, already scaled
+ * vertically, so a character is blitted with a few shifted ORs per
+ * column instead of one pixel (or square) per font bit.
+ */
+typedef struct {
+    const uint8_t *font; /**< source font, same format as font.h */
+    uint8_t scale;       /**< scale the columns were expanded for */
+    uint8_t first;       /**< first cached ascii char */
+    uint8_t last;        /**< last cached ascii char */
+    uint8_t columns;     /**< font columns per glyph (not scaled) */
+    uint8_t height;      /**< glyph height in pixels (scaled) */
+    uint8_t advance;     /**< pixels between glyph origins (scaled) */
+    uint32_t *bits;      /**< expanded columns, glyph-major */
+} gfx_glyph_cache_t;
+
+#define GFX_GLYPH_CACHE_MAX_HEIGHT 32
+#define GFX_GLYPH_CACHE_WORDS(glyphs, columns) ((glyphs) * (columns))
+#define GFX_FONT_8X5_CACHE_WORDS GFX_GLYPH_CACHE_WORDS(126 - 32 + 1, 5)
+
 char gfx_init(ssd1306_t *p, uint16_t width, uint16_t height);
 void gfx_clear_buffer(ssd1306_t *p);
 void gfx_show(ssd1306_t *p);
+// Sends only the column span of each page touched since the last show.
+void gfx_show_dirty(ssd1306_t *p);
 void gfx_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2,
                    int32_t y2);
 void gfx_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
@@ -25,4 +50,19 @@ void gfx_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y,
                                uint32_t scale, const uint8_t *font,
                                const char *s);
 
+bool gfx_glyph_cache_init(gfx_glyph_cache_t *c, uint8_t scale,
+                          uint32_t *storage, size_t words);
+bool gfx_glyph_cache_init_with_font(gfx_glyph_cache_t *c, const uint8_t *font,
+                                    uint8_t scale, uint32_t *storage,
+                                    size_t words);
+void gfx_draw_string_cached(ssd1306_t *p, const gfx_glyph_cache_t *c,
+                            uint32_t x, uint32_t y, const char *s);
+// Overwrites a fixed-width text field: cells not covered by s are cleared.
+void gfx_draw_field(ssd1306_t *p, const gfx_glyph_cache_t *c, uint32_t x,
+                    uint32_t y, uint8_t cells, const char *s);
+// Right-aligned decimal field, redrawn in place without sprintf.
+void gfx_draw_uint_field(ssd1306_t *p, const gfx_glyph_cache_t *c,
+                         uint32_t x, uint32_t y, uint8_t digits,
+                         uint32_t value);
+
 #endif // gfx_H
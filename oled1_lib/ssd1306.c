@@ -1,17 +1,5 @@
 #include "ssd1306.h"
 
-inline void spi_cs_select(void) {
-    asm volatile("nop \n nop \n nop");
-    gpio_put(PIN_CS, 0); // Active low
-    asm volatile("nop \n nop \n nop");
-}
-
-inline void spi_cs_deselect(void) {
-    asm volatile("nop \n nop \n nop");
-    gpio_put(PIN_CS, 1);
-    asm volatile("nop \n nop \n nop");
-}
-
 void ssd1306_set_display_start_line_address(uint8_t address) {
     // Make sure address is 6 bits
     address &= 0x3F;
@@ -62,52 +50,6 @@ void gfx_mono_ssd1306_put_byte(uint8_t page, uint8_t column, uint8_t data,
     ssd1306_write_data(data);
 }
 
-void ssd1306_interface_init(void) {
-    // active low
-    gpio_init(SSD1306_RST_PIN);
-    gpio_set_dir(SSD1306_RST_PIN, GPIO_OUT);
-    gpio_put(SSD1306_RST_PIN, 1);
-
-    // Data / command select for OLED display. High = data, low =command.
-    gpio_init(SSD1306_DATA_CMD_SEL);
-    gpio_set_dir(SSD1306_DATA_CMD_SEL, GPIO_OUT);
-    gpio_put(SSD1306_DATA_CMD_SEL, 1);
-
-    // CS pin
-    gpio_init(PIN_CS);
-    gpio_set_dir(PIN_CS, GPIO_OUT);
-    gpio_put(PIN_CS, 1);
-
-    // spi_init(SPI_PORT, 1000000); 10 * 1024 * 1024
-    spi_init(SPI_PORT, 2000000);
-    spi_set_format(SPI_PORT, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
-    gpio_set_function(PIN_SCK, GPIO_FUNC_SPI);
-    gpio_set_function(PIN_TX, GPIO_FUNC_SPI);
-}
-
-void ssd1306_hard_reset(void) {
-    gpio_put(SSD1306_RST_PIN, 0);
-    busy_wait_us(SSD1306_LATENCY);
-    gpio_put(SSD1306_RST_PIN, 1);
-    busy_wait_us(SSD1306_LATENCY);
-}
-
-void ssd1306_write_command(uint8_t command) {
-    gpio_put(SSD1306_DATA_CMD_SEL, 0);
-    spi_cs_select();
-    spi_write_blocking(SPI_PORT, &command, 1);
-    // spi_cs_deselect();
-    busy_wait_us_32(4);
-}
-
-void ssd1306_write_data(uint8_t data) {
-    gpio_put(SSD1306_DATA_CMD_SEL, 1);
-    spi_cs_select();
-    spi_write_blocking(SPI_PORT, &data, 1);
-    // spi_cs_deselect();
-    busy_wait_us_32(4);
-}
-
 void ssd1306_put_page(uint8_t *data, uint8_t page, uint8_t column,
                       uint8_t width) {
     ssd1306_set_page_address(page);
@@ -118,56 +60,60 @@ void ssd1306_put_page(uint8_t *data, uint8_t page, uint8_t column,
     } while (--width);
 }
 
-void ssd1306_init(void) {
-    ssd1306_interface_init();
-    ssd1306_hard_reset();
-    // 1/32 Duty (0x0F~0x3F)
-    ssd1306_write_command(SSD1306_CMD_SET_MULTIPLEX_RATIO);
-    ssd1306_write_command(0x1F);
+// Column/page window used by the horizontal addressing mode selected in
+// ssd1306_init; data written afterwards wraps inside it.
+void ssd1306_set_window(uint8_t col_start, uint8_t col_end, uint8_t page_start,
+                        uint8_t page_end) {
+    const uint8_t cmd[] = {
+        SSD1306_CMD_SET_COLUMN_ADDRESS, col_start & 0x7F, col_end & 0x7F,
+        SSD1306_CMD_SET_PAGE_ADDRESS,   page_start & 0x07, page_end & 0x07,
+    };
+    ssd1306_write_commands(cmd, sizeof(cmd));
+}
 
-    // Shift Mapping RAM Counter (0x00~0x3F)
-    ssd1306_write_command(SSD1306_CMD_SET_DISPLAY_OFFSET);
-    ssd1306_write_command(0x00);
+void ssd1306_put_span(const uint8_t *data, uint8_t page, uint8_t column,
+                      uint8_t width) {
+    if (!width)
+        return;
 
-    // Set Mapping RAM Display Start Line (0x00~0x3F)
-    ssd1306_write_command(SSD1306_CMD_SET_DISPLAY_START_LINE(0x40));
+    ssd1306_set_window(column, column + width - 1, page, page);
+    ssd1306_write_data_buf(data, width);
+}
 
+// Whole bring-up sequence, streamed with D/C low in a single burst.
+const uint8_t ssd1306_init_seq[] = {
+    // 1/32 or 1/64 Duty (0x0F~0x3F)
+    SSD1306_CMD_SET_MULTIPLEX_RATIO, GFX_MONO_LCD_HEIGHT - 1,
+    // Shift Mapping RAM Counter (0x00~0x3F)
+    SSD1306_CMD_SET_DISPLAY_OFFSET, 0x00,
     // Set Mapping RAM Display Start Line (0x00~0x3F)
-    ssd1306_write_command(SSD1306_CMD_SET_MEMORY_ADDRESSING_MODE);
-    ssd1306_write_command(0);
-
+    SSD1306_CMD_SET_DISPLAY_START_LINE(0x00),
+    // Horizontal addressing, windows set by ssd1306_set_window
+    SSD1306_CMD_SET_MEMORY_ADDRESSING_MODE, 0x00,
     // Set Column Address 0 Mapped to SEG0
-    ssd1306_write_command(SSD1306_CMD_SET_SEGMENT_RE_MAP_COL127_SEG0);
-
+    SSD1306_CMD_SET_SEGMENT_RE_MAP_COL127_SEG0,
     // Set COM/Row Scan Scan from COM63 to 0
-    ssd1306_write_command(0xC8);
-
-    // Set COM Pins hardware configuration
-    ssd1306_write_command(SSD1306_CMD_SET_COM_PINS);
-    ssd1306_write_command(0x02);
-
-    ssd1306_set_contrast(0x8F);
-
+    SSD1306_CMD_SET_COM_OUTPUT_SCAN_DOWN,
+    // Set COM Pins hardware configuration (sequential 32, alternative 64)
+    SSD1306_CMD_SET_COM_PINS, GFX_MONO_LCD_HEIGHT == 64 ? 0x12 : 0x02,
+    SSD1306_CMD_SET_CONTRAST_CONTROL_FOR_BANK0, 0x8F,
     // Disable Entire display On
-    ssd1306_write_command(SSD1306_CMD_ENTIRE_DISPLAY_AND_GDDRAM_ON);
-
-    ssd1306_display_invert_disable();
-
+    SSD1306_CMD_ENTIRE_DISPLAY_AND_GDDRAM_ON,
+    SSD1306_CMD_SET_NORMAL_DISPLAY,
     // Set Display Clock Divide Ratio / Oscillator Frequency (Default => 0x80)
-    ssd1306_write_command(SSD1306_CMD_SET_DISPLAY_CLOCK_DIVIDE_RATIO);
-    ssd1306_write_command(0x80);
-
+    SSD1306_CMD_SET_DISPLAY_CLOCK_DIVIDE_RATIO, 0x80,
     // Enable charge pump regulator
-    ssd1306_write_command(SSD1306_CMD_SET_CHARGE_PUMP_SETTING);
-    ssd1306_write_command(0x14);
-
-    // Set VCOMH Deselect Level
-    ssd1306_write_command(SSD1306_CMD_SET_VCOMH_DESELECT_LEVEL);
-    ssd1306_write_command(0x40); // Default => 0x20 (0.77*VCC)
-
+    SSD1306_CMD_SET_CHARGE_PUMP_SETTING, 0x14,
+    // Set VCOMH Deselect Level, default => 0x20 (0.77*VCC)
+    SSD1306_CMD_SET_VCOMH_DESELECT_LEVEL, 0x40,
     // Set Pre-Charge as 15 Clocks & Discharge as 1 Clock
-    ssd1306_write_command(SSD1306_CMD_SET_PRE_CHARGE_PERIOD);
-    ssd1306_write_command(0xF1);
+    SSD1306_CMD_SET_PRE_CHARGE_PERIOD, 0xF1,
+    SSD1306_CMD_SET_DISPLAY_ON,
+};
+const size_t ssd1306_init_seq_len = sizeof(ssd1306_init_seq);
 
-    ssd1306_display_on();
+void ssd1306_init(void) {
+    ssd1306_interface_init();
+    ssd1306_hard_reset();
+    ssd1306_write_commands(ssd1306_init_seq, ssd1306_init_seq_len);
 }
@@ -1,10 +1,9 @@
 #ifndef SSD1306_H
 #define SSD1306_H
 
-#include "hardware/gpio.h"
-#include "hardware/spi.h"
-#include "pico/stdlib.h"
-#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #define SSD1306_CMD_COL_ADD_SET_LSB(column) (0x00 | (column))
 #define SSD1306_CMD_COL_ADD_SET_MSB(column) (0x10 | (column))
@@ -37,37 +36,68 @@
 #ifndef GFX_MONO_LCD_HEIGHT
 #define GFX_MONO_LCD_HEIGHT 32
 #endif
+#if GFX_MONO_LCD_HEIGHT != 32 && GFX_MONO_LCD_HEIGHT != 64
+#error "GFX_MONO_LCD_HEIGHT must be 32 or 64"
+#endif
 #define GFX_MONO_LCD_PIXELS_PER_BYTE 8
 #define GFX_MONO_LCD_PAGES (GFX_MONO_LCD_HEIGHT / GFX_MONO_LCD_PIXELS_PER_BYTE)
 #define GFX_MONO_LCD_FRAMEBUFFER_SIZE \
     ((GFX_MONO_LCD_WIDTH * GFX_MONO_LCD_HEIGHT) / GFX_MONO_LCD_PIXELS_PER_BYTE)
 
+#ifndef SSD1306_RST_PIN
 #define SSD1306_RST_PIN 14
+#endif
+#ifndef SSD1306_DATA_CMD_SEL
 #define SSD1306_DATA_CMD_SEL 15
+#endif
 
+#ifndef PIN_SCK
 #define PIN_SCK 10
+#endif
+#ifndef PIN_TX
 #define PIN_TX 11
+#endif
+#ifndef PIN_CS
 #define PIN_CS 9
+#endif
+#ifndef SPI_PORT
 #define SPI_PORT spi1
+#endif
 #define SSD1306_LATENCY 10
 
-inline void spi_cs_select(void);
-inline void spi_cs_deselect(void);
-inline void ssd1306_set_display_start_line_address(uint8_t address);
-inline void ssd1306_set_column_address(uint8_t address);
-inline void ssd1306_set_page_address(uint8_t address);
-inline void ssd1306_display_on(void);
-inline void ssd1306_display_off(void);
-inline uint8_t ssd1306_set_contrast(uint8_t contrast);
-inline void ssd1306_display_invert_enable(void);
-inline void ssd1306_display_invert_disable(void);
+void spi_cs_select(void);
+void spi_cs_deselect(void);
+void ssd1306_set_display_start_line_address(uint8_t address);
+void ssd1306_set_column_address(uint8_t address);
+void ssd1306_set_page_address(uint8_t address);
+void ssd1306_display_on(void);
+void ssd1306_display_off(void);
+uint8_t ssd1306_set_contrast(uint8_t contrast);
+void ssd1306_display_invert_enable(void);
+void ssd1306_display_invert_disable(void);
 
 void gfx_mono_ssd1306_put_byte(uint8_t page, uint8_t column, uint8_t data,
                                bool force);
+void ssd1306_put_page(uint8_t *data, uint8_t page, uint8_t column,
+                      uint8_t width);
+void ssd1306_set_window(uint8_t col_start, uint8_t col_end, uint8_t page_start,
+                        uint8_t page_end);
+void ssd1306_put_span(const uint8_t *data, uint8_t page, uint8_t column,
+                      uint8_t width);
+void ssd1306_init(void);
+
+extern const uint8_t ssd1306_init_seq[];
+extern const size_t ssd1306_init_seq_len;
+
+// Bus backend. ssd1306_spi.c drives the Pico's SPI; a host build links its
+// own implementation instead (see host/oled_sim).
 void ssd1306_interface_init(void);
 void ssd1306_hard_reset(void);
 void ssd1306_write_command(uint8_t command);
 void ssd1306_write_data(uint8_t data);
-void ssd1306_init(void);
+void ssd1306_write_commands(const uint8_t *commands, size_t len);
+void ssd1306_write_data_buf(const uint8_t *data, size_t len);
+void ssd1306_init_async(void);
+bool ssd1306_init_done(void);
 
 #endif // SSD1306_H
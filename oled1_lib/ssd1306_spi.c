@@ -0,0 +1,136 @@
+#include "ssd1306.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/spi.h"
+#include "pico/stdlib.h"
+
+// SPI backend for ssd1306.c: pins, reset line and the byte stream.
+
+void spi_cs_select(void) {
+    asm volatile("nop \n nop \n nop");
+    gpio_put(PIN_CS, 0); // Active low
+    asm volatile("nop \n nop \n nop");
+}
+
+void spi_cs_deselect(void) {
+    asm volatile("nop \n nop \n nop");
+    gpio_put(PIN_CS, 1);
+    asm volatile("nop \n nop \n nop");
+}
+
+void ssd1306_interface_init(void) {
+    // active low
+    gpio_init(SSD1306_RST_PIN);
+    gpio_set_dir(SSD1306_RST_PIN, GPIO_OUT);
+    gpio_put(SSD1306_RST_PIN, 1);
+
+    // Data / command select for OLED display. High = data, low =command.
+    gpio_init(SSD1306_DATA_CMD_SEL);
+    gpio_set_dir(SSD1306_DATA_CMD_SEL, GPIO_OUT);
+    gpio_put(SSD1306_DATA_CMD_SEL, 1);
+
+    // CS pin
+    gpio_init(PIN_CS);
+    gpio_set_dir(PIN_CS, GPIO_OUT);
+    gpio_put(PIN_CS, 1);
+
+    // spi_init(SPI_PORT, 1000000); 10 * 1024 * 1024
+    spi_init(SPI_PORT, 2000000);
+    spi_set_format(SPI_PORT, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    gpio_set_function(PIN_SCK, GPIO_FUNC_SPI);
+    gpio_set_function(PIN_TX, GPIO_FUNC_SPI);
+}
+
+void ssd1306_hard_reset(void) {
+    gpio_put(SSD1306_RST_PIN, 0);
+    busy_wait_us(SSD1306_LATENCY);
+    gpio_put(SSD1306_RST_PIN, 1);
+    busy_wait_us(SSD1306_LATENCY);
+}
+
+void ssd1306_write_command(uint8_t command) {
+    gpio_put(SSD1306_DATA_CMD_SEL, 0);
+    spi_cs_select();
+    spi_write_blocking(SPI_PORT, &command, 1);
+    // spi_cs_deselect();
+    busy_wait_us_32(4);
+}
+
+// Burst variants: one CS/D/C setup for the whole buffer. spi_write_blocking
+// returns once the shifter is idle, so D/C can change right after.
+void ssd1306_write_commands(const uint8_t *commands, size_t len) {
+    gpio_put(SSD1306_DATA_CMD_SEL, 0);
+    spi_cs_select();
+    spi_write_blocking(SPI_PORT, commands, len);
+}
+
+void ssd1306_write_data_buf(const uint8_t *data, size_t len) {
+    gpio_put(SSD1306_DATA_CMD_SEL, 1);
+    spi_cs_select();
+    spi_write_blocking(SPI_PORT, data, len);
+}
+
+void ssd1306_write_data(uint8_t data) {
+    gpio_put(SSD1306_DATA_CMD_SEL, 1);
+    spi_cs_select();
+    spi_write_blocking(SPI_PORT, &data, 1);
+    // spi_cs_deselect();
+    busy_wait_us_32(4);
+}
+
+static int ssd1306_dma_chan = -1;
+static volatile bool ssd1306_reset_done;
+
+static int64_t ssd1306_init_dma_start(alarm_id_t id, void *user_data) {
+    dma_channel_config c = dma_channel_get_default_config(ssd1306_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, spi_get_dreq(SPI_PORT, true));
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+
+    gpio_put(SSD1306_DATA_CMD_SEL, 0);
+    spi_cs_select();
+    dma_channel_configure(ssd1306_dma_chan, &c, &spi_get_hw(SPI_PORT)->dr,
+                          ssd1306_init_seq, ssd1306_init_seq_len, true);
+    ssd1306_reset_done = true;
+    return 0;
+}
+
+// No alarm (the default pool is full, or the time had already passed):
+// the blocking bring-up of ssd1306_init, so ssd1306_init_done still
+// turns true.
+static void ssd1306_init_sync(void) {
+    ssd1306_hard_reset();
+    ssd1306_write_commands(ssd1306_init_seq, ssd1306_init_seq_len);
+    ssd1306_reset_done = true;
+}
+
+static int64_t ssd1306_reset_release(alarm_id_t id, void *user_data) {
+    gpio_put(SSD1306_RST_PIN, 1);
+    if (add_alarm_in_us(SSD1306_LATENCY, ssd1306_init_dma_start, NULL, false) <= 0)
+        ssd1306_init_sync();
+    return 0;
+}
+
+// Same bring-up as ssd1306_init, but the reset pulse is timed by alarms and
+// the command table goes out by DMA, so the caller keeps initializing the
+// rest of the system. Poll ssd1306_init_done before the first frame.
+void ssd1306_init_async(void) {
+    ssd1306_interface_init();
+    if (ssd1306_dma_chan < 0)
+        ssd1306_dma_chan = dma_claim_unused_channel(true);
+    ssd1306_reset_done = false;
+
+    gpio_put(SSD1306_RST_PIN, 0);
+    // fire_if_past false: 0 then means the callback never ran.
+    if (add_alarm_in_us(SSD1306_LATENCY, ssd1306_reset_release, NULL, false) <= 0)
+        ssd1306_init_sync();
+}
+
+bool ssd1306_init_done(void) {
+    if (ssd1306_dma_chan < 0)
+        return true;
+
+    return ssd1306_reset_done && !dma_channel_is_busy(ssd1306_dma_chan) &&
+           !spi_is_busy(SPI_PORT);
+}
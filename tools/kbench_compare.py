@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Collect and compare kernel microbenchmark runs.
+
+    build-host/kernel_bench/kernel_bench > posix.txt
+    python3 tools/kbench_compare.py --port /dev/ttyACM0 > rp2040.txt
+    python3 tools/kbench_compare.py baseline.txt current.txt [--tolerance 10]
+
+With --port the RP2040 kernel_bench firmware is started and its output
+copied to stdout.  With two files, ns_per_op is compared per
+(port, test); the exit status is 1 if any test got slower by more than
+--tolerance percent, so it can gate CI.
+"""
+
+import argparse
+import sys
+
+
+def parse(lines):
+    """{(port, test): fields} from "kbench key=value ..." lines."""
+    runs = {}
+    for line in lines:
+        words = line.split()
+        if not words or words[0] != "kbench":
+            continue
+        fields = dict(w.split("=", 1) for w in words[1:] if "=" in w)
+        if "test" in fields:
+            runs[(fields["port"], fields["test"])] = fields
+    return runs
+
+
+def capture(port):
+    import serial
+
+    ser = serial.Serial(port, 115200, timeout=30)
+    ser.reset_input_buffer()
+    ser.write(b"\n")
+    while True:
+        line = ser.readline().decode("ascii", "replace")
+        if not line:
+            raise TimeoutError("no output from kernel_bench")
+        if line.startswith("kbench"):
+            sys.stdout.write(line)
+        if line.startswith("kbench") and line.split()[-1] == "end":
+            return 0
+
+
+def compare(base_path, cur_path, tolerance):
+    with open(base_path) as f:
+        base = parse(f)
+    with open(cur_path) as f:
+        cur = parse(f)
+    worse = 0
+    print("%-8s %-26s %12s %12s %8s" % ("port", "test", "base_ns", "cur_ns", "delta"))
+    for key in sorted(set(base) | set(cur)):
+        if key not in base or key not in cur:
+            print("%-8s %-26s %s" % (key[0], key[1], "only in " + ("current" if key in cur else "baseline")))
+            continue
+        b = float(base[key]["ns_per_op"])
+        c = float(cur[key]["ns_per_op"])
+        delta = (c - b) / b * 100 if b else 0.0
+        flag = ""
+        if delta > tolerance:
+            flag = "  REGRESSION"
+            worse += 1
+        print("%-8s %-26s %12.1f %12.1f %+7.1f%%%s" % (key[0], key[1], b, c, delta, flag))
+    return 1 if worse else 0
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("files", nargs="*")
+    ap.add_argument("--port")
+    ap.add_argument("--tolerance", type=float, default=10.0)
+    args = ap.parse_args()
+    if args.port:
+        return capture(args.port)
+    if len(args.files) != 2:
+        ap.error("need a baseline and a current result file (or --port)")
+    return compare(args.files[0], args.files[1], args.tolerance)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
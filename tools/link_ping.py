@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""Round-trip latency of the serial link and the device clock offset.
+
+    python3 tools/link_ping.py /dev/ttyACM0 [--hz 100] [--seconds 10]
+                               [--burst 200] [--label <build>]
+
+Sends a stamped 'P' probe --hz times a second while the device keeps
+streaming (move the stick, or add --burst N to have it send N 'T' frames
+before every 20th probe).  The device stamps the probe when cmd_task
+parses it (t_rx) and when uart_task writes the reply (t_tx), behind the
+frames already queued, so each probe gives four clocks:
+
+    t0  host sends        t1  device receives
+    t3  host receives     t2  device sends
+
+and, per probe,
+
+    rtt      t3 - t0                   what a command costs end to end
+    queue    t2 - t1                   time waiting behind real frames
+    link     rtt - queue               the two USB legs together
+    offset   ((t1 - t0) + (t2 - t3)) / 2
+
+The offset is device minus host clock, assuming both legs are equally
+long; probes that took the shortest link time give the best estimate, so
+the offset is the linear fit (offset + drift * t) through the minimum of
+each one-second window.  With it, any device timestamp maps to host time
+and the device -> host leg of a frame is t3 - (t2 - offset): the one-way
+latency the 'down' line reports.  Add the firmware's sample -> TX
+latency (HUD) to get sample -> host.
+
+One key=value line per measurement, p50/p99/max in us.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+HDR, FTR = 0xD0, 0xDF
+MAX_PAYLOAD = 32        # CMD_MAX_PAYLOAD in main/cmd.h
+BURST_EVERY = 20
+
+
+class Link:
+    def __init__(self, port):
+        self.ser = serial.Serial(port, 115200, timeout=0)
+        self.buf = bytearray()
+
+    def send(self, cmd, payload=b""):
+        self.ser.write(bytes([HDR, ord(cmd), len(payload)]) + payload + bytes([FTR]))
+
+    def frames(self, until):
+        """D0 frames as (cmd, payload, host time in us) until the monotonic
+        deadline `until`; other packets are skipped."""
+        while True:
+            left = until - time.monotonic()
+            if left <= 0:
+                return
+            self.ser.timeout = left
+            chunk = self.ser.read(max(1, self.ser.in_waiting))
+            t = time.monotonic_ns() // 1000
+            self.buf += chunk
+            while True:
+                i = self.buf.find(HDR)
+                if i < 0:
+                    self.buf.clear()
+                    break
+                del self.buf[:i]
+                if len(self.buf) < 3:
+                    break
+                # A D0 inside an axis value must not hold the stream back
+                # while a bogus length fills up.
+                n = self.buf[2]
+                if n > MAX_PAYLOAD:
+                    del self.buf[:1]
+                    continue
+                if len(self.buf) < 4 + n:
+                    break
+                if self.buf[3 + n] != FTR:
+                    del self.buf[:1]
+                    continue
+                cmd, payload = chr(self.buf[1]), bytes(self.buf[3:3 + n])
+                del self.buf[:4 + n]
+                yield cmd, payload, t
+
+
+class Unwrap:
+    """The device clock is time_us_32(): 32 bits, wraps every 71 minutes."""
+
+    def __init__(self):
+        self.base = 0
+        self.last = None
+
+    def __call__(self, v):
+        if self.last is not None and v < self.last and self.last - v > 1 << 31:
+            self.base += 1 << 32
+        self.last = v
+        return self.base + v
+
+
+def fit(points):
+    """Least squares y = a + b * x."""
+    n = len(points)
+    mx = sum(p[0] for p in points) / n
+    my = sum(p[1] for p in points) / n
+    sxx = sum((p[0] - mx) ** 2 for p in points)
+    b = sum((p[0] - mx) * (p[1] - my) for p in points) / sxx if sxx else 0.0
+    return my - b * mx, b
+
+
+def pct(values):
+    v = sorted(values)
+    return v[len(v) // 2], v[len(v) * 99 // 100], v[-1]
+
+
+def report(label, what, values):
+    if not values:
+        print("build=%s measure=%s n=0" % (label, what))
+        return
+    p50, p99, mx = pct(values)
+    print("build=%s measure=%s n=%d p50_us=%d p99_us=%d max_us=%d"
+          % (label, what, len(values), p50, p99, mx))
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("port")
+    ap.add_argument("--hz", type=float, default=100.0)
+    ap.add_argument("--seconds", type=float, default=10.0)
+    ap.add_argument("--burst", type=int, default=0,
+                    help="'T' frames requested before every %dth probe" % BURST_EVERY)
+    ap.add_argument("--label", default="build")
+    args = ap.parse_args()
+
+    link = Link(args.port)
+    unwrap = Unwrap()
+    sent = {}           # seq -> t0
+    probes = []         # (t0, t1, t2, t3)
+    seq = 0
+    period = 1.0 / args.hz
+    start = time.monotonic()
+    next_send = start
+    while next_send - start < args.seconds or (sent and time.monotonic() - next_send < 1.0):
+        if next_send - start < args.seconds and time.monotonic() >= next_send:
+            if args.burst and seq % BURST_EVERY == 0:
+                link.send("T", struct.pack(">H", min(args.burst, 0xFFFF)))
+            sent[seq] = time.monotonic_ns() // 1000
+            link.send("P", struct.pack(">I", seq))
+            seq += 1
+            next_send += period
+        sending = next_send - start < args.seconds
+        for cmd, payload, t3 in link.frames(next_send if sending else time.monotonic() + 0.05):
+            if cmd != "P" or len(payload) != 12:
+                continue
+            s, t1, t2 = struct.unpack(">3I", payload)
+            t0 = sent.pop(s, None)
+            if t0 is not None:
+                probes.append((t0, unwrap(t1), unwrap(t2), t3))
+
+    print("build=%s measure=probes sent=%d answered=%d lost=%d"
+          % (args.label, seq, len(probes), len(sent)))
+    if not probes:
+        print("no replies: is the firmware new enough to know 'P'?", file=sys.stderr)
+        return 1
+
+    rtt = [t3 - t0 for t0, t1, t2, t3 in probes]
+    queue = [t2 - t1 for t0, t1, t2, t3 in probes]
+    report(args.label, "rtt", rtt)
+    report(args.label, "queue", queue)
+    report(args.label, "link", [r - q for r, q in zip(rtt, queue)])
+
+    # Best probe of each second: least time on the wire, least asymmetry.
+    t_base = probes[0][0]
+    best = {}
+    for t0, t1, t2, t3 in probes:
+        w = (t0 - t_base) // 1000000
+        link_us = (t3 - t0) - (t2 - t1)
+        offset = ((t1 - t0) + (t2 - t3)) / 2
+        if w not in best or link_us < best[w][0]:
+            best[w] = (link_us, (t0 + t3) / 2 - t_base, offset)
+    a, b = fit([(x, off) for _, x, off in best.values()])
+    err = max(abs(off - (a + b * x)) for _, x, off in best.values())
+    print("build=%s measure=offset offset_us=%.0f drift_ppm=%.2f fit_err_us=%.0f windows=%d"
+          % (args.label, a + b * (probes[-1][3] - t_base), b * 1e6, err, len(best)))
+
+    def offset_at(t):
+        return a + b * (t - t_base)
+
+    report(args.label, "up", [t1 - offset_at(t0) - t0 for t0, t1, t2, t3 in probes])
+    report(args.label, "down", [t3 - (t2 - offset_at(t3)) for t0, t1, t2, t3 in probes])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
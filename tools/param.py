@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+"""Read and tune the firmware's input parameters over the serial link.
+
+    python3 tools/param.py /dev/ttyACM0 list
+    python3 tools/param.py /dev/ttyACM0 get [name ...]
+    python3 tools/param.py /dev/ttyACM0 set ganho=30 zona_morta=600
+    python3 tools/param.py /dev/ttyACM0 sweep ganho 10 90 10 [--dwell 2]
+                                       [--exec "python3 tools/link_ping.py {port} --label g{value}"]
+    python3 tools/param.py /dev/ttyACM0 save | config | wipe
+
+The names, defaults and ranges come from the device ('Q', main/params.h),
+so this tool needs no update when a parameter is added.  'set' stages
+every value ('S') and then applies them together ('A'): the input loops
+switch to the whole new set at their next sample cycle, never to half
+of it.  Changes last until a reset unless 'save' writes the live set to
+the flash log ('C', main/config_store.h), which the device loads at boot;
+'config' prints the log's counters (boot load time, saves, erases, how
+long core 0 was off flash) and 'wipe' erases it.
+
+'sweep' steps one parameter from start to stop, applies each value,
+reads it back, waits --dwell seconds and, with --exec, runs a command
+({port}, {name} and {value} are substituted; the port is closed while it
+runs).  One key=value line per step; the original value is restored at
+the end.
+"""
+
+import argparse
+import shlex
+import struct
+import subprocess
+import sys
+import time
+
+import serial
+
+HDR, FTR = 0xD0, 0xDF
+MAX_PAYLOAD = 32        # CMD_MAX_PAYLOAD in main/cmd.h
+STATUS = {0: "ok", 1: "bad_id", 2: "out_of_range"}
+CONFIG_STATUS = {0: "ok", 1: "empty", 2: "busy (turn ENABLE off)", 3: "flash_error",
+                 4: "no_region"}
+CONFIG_OPS = {"config": 0, "save": 1, "wipe": 2}
+
+
+class Link:
+    def __init__(self, port):
+        self.ser = serial.Serial(port, 115200, timeout=1)
+        self.buf = bytearray()
+
+    def close(self):
+        self.ser.close()
+
+    def send(self, cmd, payload=b""):
+        self.ser.write(bytes([HDR, ord(cmd), len(payload)]) + payload + bytes([FTR]))
+
+    def frame(self):
+        """Next D0 frame as (cmd, payload); other packets are skipped."""
+        while True:
+            i = self.buf.find(HDR)
+            if i < 0:
+                self.buf.clear()
+            elif i > 0:
+                del self.buf[:i]
+            if len(self.buf) >= 3 and self.buf[2] > MAX_PAYLOAD:
+                del self.buf[:1]
+                continue
+            if len(self.buf) >= 3 and len(self.buf) >= 4 + self.buf[2]:
+                n = self.buf[2]
+                if self.buf[3 + n] == FTR:
+                    cmd, payload = self.buf[1], bytes(self.buf[3:3 + n])
+                    del self.buf[:4 + n]
+                    return chr(cmd), payload
+                del self.buf[:1]
+                continue
+            chunk = self.ser.read(max(1, self.ser.in_waiting))
+            if not chunk:
+                raise TimeoutError("no reply from device")
+            self.buf += chunk
+
+    def expect(self, cmd):
+        while True:
+            c, payload = self.frame()
+            if c == cmd:
+                return payload
+
+
+class Params:
+    def __init__(self, link):
+        self.link = link
+        self.by_name = {}
+        self.by_id = {}
+        count = None
+        link.send("Q")
+        while count is None or len(self.by_id) < count:
+            p = link.expect("Q")
+            pid, count, default, lo, hi, n = struct.unpack(">BB3iB", p[:15])
+            name = p[15:15 + n].decode()
+            self.by_name[name] = (pid, default, lo, hi)
+            self.by_id[pid] = name
+
+    def id(self, name):
+        if name not in self.by_name:
+            raise SystemExit("unknown parameter %s (have: %s)"
+                             % (name, " ".join(sorted(self.by_name))))
+        return self.by_name[name][0]
+
+    def get(self, name):
+        self.link.send("V", bytes([self.id(name)]))
+        _, live, staged = struct.unpack(">B2i", self.link.expect("V"))
+        return live, staged
+
+    def stage(self, name, value):
+        self.link.send("S", struct.pack(">Bi", self.id(name), value))
+        _, status, staged = struct.unpack(">BBi", self.link.expect("S"))
+        if status:
+            _, _, lo, hi = self.by_name[name]
+            raise SystemExit("%s=%d: %s (range %d..%d)"
+                             % (name, value, STATUS.get(status, status), lo, hi))
+
+    def apply(self):
+        self.link.send("A")
+        return struct.unpack(">I", self.link.expect("A"))[0]
+
+    def set(self, values):
+        for name, value in values:
+            self.stage(name, value)
+        return self.apply()
+
+
+def cmd_list(params, args):
+    for pid in sorted(params.by_id):
+        name = params.by_id[pid]
+        _, default, lo, hi = params.by_name[name]
+        live, _ = params.get(name)
+        print("param=%s id=%d value=%d default=%d min=%d max=%d"
+              % (name, pid, live, default, lo, hi))
+
+
+def cmd_get(params, args):
+    for name in args.names or [params.by_id[i] for i in sorted(params.by_id)]:
+        live, staged = params.get(name)
+        extra = "" if live == staged else " staged=%d" % staged
+        print("param=%s value=%d%s" % (name, live, extra))
+
+
+def cmd_set(params, args):
+    values = []
+    for item in args.assignments:
+        name, sep, value = item.partition("=")
+        if not sep:
+            raise SystemExit("expected name=value, got %s" % item)
+        values.append((name, int(value, 0)))
+    seq = params.set(values)
+    for name, value in values:
+        live, _ = params.get(name)
+        print("param=%s value=%d seq=%d" % (name, live, seq))
+        if live != value:
+            return 1
+    return 0
+
+
+def cmd_sweep(params, args):
+    original, _ = params.get(args.name)
+    step = args.step if args.step else 1
+    values = list(range(args.start, args.stop + (1 if step > 0 else -1), step))
+    try:
+        for value in values:
+            t0 = time.monotonic()
+            seq = params.set([(args.name, value)])
+            live, _ = params.get(args.name)
+            apply_ms = (time.monotonic() - t0) * 1000
+            time.sleep(args.dwell)
+            status = ""
+            if args.exec:
+                params.link.close()
+                command = args.exec.format(port=args.port, name=args.name, value=value)
+                rc = subprocess.call(shlex.split(command))
+                params.link.ser.open()
+                params.link.buf.clear()
+                status = " exec_status=%d" % rc
+            print("sweep param=%s value=%d readback=%d seq=%d apply_ms=%.1f%s"
+                  % (args.name, value, live, seq, apply_ms, status))
+            sys.stdout.flush()
+    finally:
+        params.set([(args.name, original)])
+    return 0
+
+
+def cmd_config(link, args):
+    link.send("C", bytes([CONFIG_OPS[args.what]]))
+    p = link.expect("C")
+    status = p[0]
+    seq, load_us, scanned, saves, erases, last_us, max_us = struct.unpack(">7I", p[1:29])
+    print("config op=%s status=%s seq=%d load_us=%d scanned=%d saves=%d erases=%d "
+          "last_blocked_us=%d max_blocked_us=%d"
+          % (args.what, CONFIG_STATUS.get(status, status), seq, load_us, scanned, saves,
+             erases, last_us, max_us))
+    return 0 if status == 0 else 1
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("port")
+    sub = ap.add_subparsers(dest="what", required=True)
+    sub.add_parser("list")
+    p = sub.add_parser("get")
+    p.add_argument("names", nargs="*")
+    p = sub.add_parser("set")
+    p.add_argument("assignments", nargs="+", metavar="name=value")
+    p = sub.add_parser("sweep")
+    p.add_argument("name")
+    p.add_argument("start", type=int)
+    p.add_argument("stop", type=int)
+    p.add_argument("step", type=int, nargs="?", default=1)
+    p.add_argument("--dwell", type=float, default=1.0)
+    p.add_argument("--exec")
+    for what in CONFIG_OPS:
+        sub.add_parser(what)
+    args = ap.parse_args()
+
+    link = Link(args.port)
+    if args.what in CONFIG_OPS:
+        return cmd_config(link, args)
+    params = Params(link)
+    handler = {"list": cmd_list, "get": cmd_get, "set": cmd_set, "sweep": cmd_sweep}
+    return handler[args.what](params, args) or 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
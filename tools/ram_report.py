@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""RAM per task from the linker map of a static-allocation build.
+
+    python3 tools/ram_report.py build/pico_emb.elf.map
+
+Objects laid out from main/app_tasks.h live in sections named
+.<output>.app_<kind>_<id> (kind: stack, tcb, qstore, queue, mbstore, msgbuf,
+evgroup, mutex), so every one shows up in the map with its address and size.
+The report groups them per task/queue and tells which SRAM bank each one
+landed in.
+"""
+
+import re
+import sys
+from collections import OrderedDict
+
+SECTION = re.compile(
+    r"^ (\.(?:bss|uninitialized_data|scratch_x|scratch_y)\.app_"
+    r"(stack|tcb|qstore|queue|mbstore|msgbuf|evgroup|mutex)_(\w+))"
+    r"(?:\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+))?")
+ADDR_SIZE = re.compile(r"^\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+\S")
+HEAP = re.compile(r"^ \.bss\.(ucHeap)\s*(?:(0x[0-9a-f]+)\s+(0x[0-9a-f]+))?")
+
+# RP2040 SRAM: banks 0-3 striped at 0x20000000, then scratch X and Y.
+BANKS = [
+    (0x20000000, 0x20040000, "main"),
+    (0x20040000, 0x20041000, "scratch_x"),
+    (0x20041000, 0x20042000, "scratch_y"),
+]
+
+
+def bank(addr):
+    for lo, hi, name in BANKS:
+        if lo <= addr < hi:
+            return name
+    return "?"
+
+
+def parse(path):
+    objs = []
+    pending = None
+    with open(path) as f:
+        for line in f:
+            if pending:
+                m = ADDR_SIZE.match(line)
+                if m:
+                    objs.append(pending + (int(m.group(1), 16), int(m.group(2), 16)))
+                pending = None
+                continue
+            m = SECTION.match(line) or HEAP.match(line)
+            if not m:
+                continue
+            if m.re is HEAP:
+                key = ("heap", "ucHeap")
+                addr, size = m.group(2), m.group(3)
+            else:
+                key = (m.group(2), m.group(3))
+                addr, size = m.group(4), m.group(5)
+            if addr is None:
+                pending = key        # long name: address/size on next line
+            else:
+                objs.append(key + (int(addr, 16), int(size, 16)))
+    # Sections discarded by --gc-sections are listed with address 0.
+    return [o for o in objs if o[2] != 0 and o[3] != 0]
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.stderr.write(__doc__)
+        return 2
+
+    objs = parse(argv[1])
+    if not objs:
+        sys.stderr.write("no app_* sections found; was the build configured "
+                         "with -DFREERTOS_STATIC_ALLOCATION=ON?\n")
+        return 1
+
+    tasks = OrderedDict()
+    queues = OrderedDict()
+    other = []
+    for kind, name, addr, size in objs:
+        if kind in ("stack", "tcb"):
+            tasks.setdefault(name, {})[kind] = (addr, size)
+        elif kind in ("qstore", "queue", "mbstore", "msgbuf"):
+            # Message buffers are listed with the queues.
+            kind = {"mbstore": "qstore", "msgbuf": "queue"}.get(kind, kind)
+            queues.setdefault(name, {})[kind] = (addr, size)
+        else:
+            other.append((kind, name, addr, size))
+
+    total = 0
+    print("%-8s %8s %6s %8s  %s" % ("task", "stack", "tcb", "total", "stack bank"))
+    for name, t in tasks.items():
+        stack = t.get("stack", (0, 0))
+        tcb = t.get("tcb", (0, 0))
+        total += stack[1] + tcb[1]
+        print("%-8s %8d %6d %8d  %s @0x%08x" % (
+            name, stack[1], tcb[1], stack[1] + tcb[1], bank(stack[0]), stack[0]))
+
+    print()
+    print("%-8s %8s %6s %8s  %s" % ("queue", "storage", "ctrl", "total", "storage bank"))
+    for name, q in queues.items():
+        store = q.get("qstore", (0, 0))
+        ctrl = q.get("queue", (0, 0))
+        total += store[1] + ctrl[1]
+        print("%-8s %8d %6d %8d  %s @0x%08x" % (
+            name, store[1], ctrl[1], store[1] + ctrl[1], bank(store[0]), store[0]))
+
+    if other:
+        print()
+        for kind, name, addr, size in other:
+            total += size
+            print("%-8s %-8s %6d  %s @0x%08x" % (kind, name, size, bank(addr), addr))
+
+    print()
+    print("kernel objects: %d bytes" % total)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
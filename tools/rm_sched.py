@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+"""Rate-monotonic priorities and schedulability of the task table.
+
+    python3 tools/rm_sched.py --port /dev/ttyACM0 [--seconds 10] [--check]
+    python3 tools/rm_sched.py --wcet X=40,Y=40,UART=60,... [--check]
+
+Periods and deadlines come from the rows of main/app_tasks.h (the
+single-core build), WCETs from the firmware's 'W' command (wcet.h
+brackets every task loop body) or from --wcet.  The tool then
+
+  * assigns rate-monotonic priorities: shorter period, higher priority.
+    Level 0 (tskIDLE_PRIORITY) is left to the idle task, which a task
+    there would time-slice with.  There are fewer priority levels than
+    distinct periods, so the closest neighbouring periods share a level;
+  * checks the Liu & Layland utilisation bound and runs exact
+    response-time analysis against each deadline.  Tasks that share a
+    level all count as interference, since FreeRTOS time-slices them.
+    The vTaskSuspendAll section in ler_mux is the blocking term;
+  * with --port, also prints the deadline misses seen at run time.
+
+--check exits with status 1 if the table's priorities differ from the
+rate-monotonic assignment, a task sits at the idle level, or a task can
+miss its deadline.
+
+The analysis is uniprocessor (default build).  Self-suspension inside a
+body (the buzzer's 100 ms beep, power_task waiting for calibration) is
+not CPU time; it only counts against the task's own deadline, which the
+table sets accordingly.
+"""
+
+import argparse
+import math
+import os
+import re
+import struct
+import sys
+import time
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+TABLE = os.path.join(ROOT, "main", "app_tasks.h")
+HEADERS = [
+    os.path.join(ROOT, "main", "input.h"),
+    os.path.join(ROOT, "main", "hud.h"),
+    os.path.join(ROOT, "freertos", "FreeRTOSConfig.h"),
+]
+
+ROW = re.compile(
+    r"ROW\((\w+),\s*(\w+),\s*\"([^\"]*)\",\s*(\d+),\s*([^,]+?),\s*([^,]+?),"
+    r"\s*([^,]+?),\s*([^,]+?),\s*([^,]+?),\s*(\w+)\)")
+DEFINE = re.compile(r"^#define\s+(\w+)\s+(.+?)\s*(?://.*|/\*.*)?$")
+
+HDR, FTR = 0xD0, 0xDF
+MUX_BLOCKING_US = 30     # ler_mux: MUX_SETTLE_US + one ADC conversion
+
+
+def load_defines():
+    defs = {"tskIDLE_PRIORITY": "0"}
+    for path in HEADERS:
+        with open(path) as f:
+            for line in f:
+                m = DEFINE.match(line.strip())
+                if m and not m.group(1).endswith("_H"):
+                    defs.setdefault(m.group(1), m.group(2))
+    return defs
+
+
+def evaluate(expr, defs, depth=0):
+    if depth > 16:
+        raise ValueError("cannot evaluate " + expr)
+    expr = re.sub(r"\b(\d+)[uUlL]+\b", r"\1", expr)
+    names = set(re.findall(r"[A-Za-z_]\w*", expr))
+    for name in names:
+        if name not in defs:
+            raise ValueError("unknown symbol %s in %s" % (name, expr))
+        value = evaluate(defs[name], defs, depth + 1)
+        expr = re.sub(r"\b%s\b" % name, str(value), expr)
+    return int(eval(expr.replace("/", "//"), {"__builtins__": {}}))
+
+
+def load_tasks():
+    """Rows of the single-core table: the #else branch of APP_INPUT_TASKS
+    and the APP_TASKS rows."""
+    defs = load_defines()
+    with open(TABLE) as f:
+        text = f.read()
+    tasks = []
+    for m in ROW.finditer(text):
+        tid, _, _, _, prio, _, period, deadline, _, _ = m.groups()
+        tasks.append({
+            "id": tid,
+            "prio": evaluate(prio, defs),
+            "T": evaluate(period, defs),
+            "D": evaluate(deadline, defs),
+        })
+    levels = evaluate("configMAX_PRIORITIES", defs)
+    return tasks, levels
+
+
+class Link:
+    def __init__(self, port):
+        import serial
+        self.ser = serial.Serial(port, 115200, timeout=1)
+        self.buf = bytearray()
+
+    def send(self, cmd, payload=b""):
+        self.ser.write(bytes([HDR, ord(cmd), len(payload)]) + payload + bytes([FTR]))
+
+    def frame(self):
+        while True:
+            i = self.buf.find(HDR)
+            if i < 0:
+                self.buf.clear()
+            elif i > 0:
+                del self.buf[:i]
+            if len(self.buf) >= 3 and len(self.buf) >= 4 + self.buf[2]:
+                n = self.buf[2]
+                if self.buf[3 + n] == FTR:
+                    cmd, payload = self.buf[1], bytes(self.buf[3:3 + n])
+                    del self.buf[:4 + n]
+                    return chr(cmd), payload
+                del self.buf[:1]
+                continue
+            chunk = self.ser.read(max(1, self.ser.in_waiting))
+            if not chunk:
+                raise TimeoutError("no reply from device")
+            self.buf += chunk
+
+
+def read_wcet(port, seconds):
+    link = Link(port)
+    link.send("W", b"\x01")         # start a fresh window
+    time.sleep(seconds)
+    link.send("W")
+    stats = {}
+    while True:
+        try:
+            cmd, p = link.frame()
+        except TimeoutError:        # one frame per task, then silence
+            break
+        if cmd != "W":
+            continue
+        n = p[1]
+        tid = p[2:2 + n].decode("ascii")
+        wcet, resp, runs, misses = struct.unpack(">4I", p[2 + n:2 + n + 16])
+        stats[tid] = {"C": wcet, "R_obs": resp, "runs": runs, "misses": misses}
+    return stats
+
+
+def rm_levels(tasks, levels):
+    """Task id -> priority in 1..levels-1. Distinct periods sorted
+    ascending; while there are more groups than levels, merge the
+    neighbours closest in period."""
+    groups = [[t] for t in sorted(tasks, key=lambda t: t["T"])]
+    merged = []
+    for g in groups:
+        if merged and merged[-1][0]["T"] == g[0]["T"]:
+            merged[-1] += g
+        else:
+            merged.append(g)
+    while len(merged) > levels - 1:
+        ratios = [merged[i + 1][0]["T"] / merged[i][0]["T"] for i in range(len(merged) - 1)]
+        i = ratios.index(min(ratios))
+        merged[i:i + 2] = [merged[i] + merged[i + 1]]
+    prio = {}
+    for rank, g in enumerate(merged):
+        for t in g:
+            prio[t["id"]] = levels - 1 - rank
+    return prio
+
+
+def response_time(task, tasks, prio, blocking):
+    """Exact RTA; None if the iteration passes the deadline."""
+    hp = [t for t in tasks if t is not task and prio[t["id"]] >= prio[task["id"]]]
+    lower = [t for t in tasks if prio[t["id"]] < prio[task["id"]]]
+    b = blocking if lower else 0
+    r = task["C"] + b
+    while True:
+        nxt = task["C"] + b + sum(math.ceil(r / t["T"]) * t["C"] for t in hp)
+        if nxt == r:
+            return r
+        if nxt > task["D"]:
+            return None
+        r = nxt
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--port")
+    ap.add_argument("--seconds", type=float, default=10.0,
+                    help="measurement window with --port (use the controller meanwhile)")
+    ap.add_argument("--wcet", help="ID=us,... overrides or replaces --port")
+    ap.add_argument("--blocking-us", type=int, default=MUX_BLOCKING_US)
+    ap.add_argument("--check", action="store_true")
+    args = ap.parse_args()
+
+    tasks, levels = load_tasks()
+    observed = read_wcet(args.port, args.seconds) if args.port else {}
+    manual = {}
+    if args.wcet:
+        for item in args.wcet.split(","):
+            k, v = item.split("=")
+            manual[k.strip()] = int(v)
+    missing = []
+    for t in tasks:
+        obs = observed.get(t["id"], {})
+        t["C"] = manual.get(t["id"], obs.get("C"))
+        t["obs"] = obs
+        if t["C"] is None:
+            missing.append(t["id"])
+    if missing:
+        sys.stderr.write("no WCET for %s (use --port or --wcet)\n" % ", ".join(missing))
+        return 2
+
+    prio = rm_levels(tasks, levels)
+    u = sum(t["C"] / t["T"] for t in tasks)
+    n = len(tasks)
+    bound = n * (2 ** (1 / n) - 1)
+
+    ok = True
+    print("%-7s %9s %9s %7s %6s %5s %3s %9s %s" % (
+        "task", "T_us", "D_us", "C_us", "U", "prio", "rm", "R_us", "runtime"))
+    for t in sorted(tasks, key=lambda t: (-prio[t["id"]], t["T"])):
+        r = response_time(t, tasks, prio, args.blocking_us)
+        if r is None:
+            ok = False
+        obs = t["obs"]
+        rt = ""
+        if obs:
+            rt = "runs=%d max_resp_us=%d misses=%d" % (obs["runs"], obs["R_obs"], obs["misses"])
+        flag = "" if t["prio"] == prio[t["id"]] else " *"
+        print("%-7s %9d %9d %7d %6.3f %5d %3d %9s %s%s" % (
+            t["id"], t["T"], t["D"], t["C"], t["C"] / t["T"], t["prio"], prio[t["id"]],
+            "MISS" if r is None else r, rt, flag))
+
+    print()
+    print("utilisation %.3f, Liu-Layland bound %.3f (%s), response-time analysis: %s"
+          % (u, bound, "met" if u <= bound else "exceeded, RTA decides",
+             "schedulable" if ok else "NOT schedulable"))
+    mismatch = [t["id"] for t in tasks if t["prio"] != prio[t["id"]]]
+    if mismatch:
+        print("priorities in app_tasks.h differ from rate-monotonic for: %s (*)" % ", ".join(mismatch))
+    idle = [t["id"] for t in tasks if t["prio"] <= 0]
+    if idle:
+        print("at the idle task's priority (0), time-sliced with it: %s" % ", ".join(idle))
+    if args.check and (mismatch or idle or not ok):
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
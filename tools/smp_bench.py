@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Sampler jitter and TX throughput of one firmware build.
+
+    python3 tools/smp_bench.py /dev/ttyACM0 --label smp [--frames 4000]
+
+Run it once per build (default, -DAPP_DUAL_CORE=ON, -DFREERTOS_SMP=ON)
+with ENABLE on and compare the lines.  Two windows are measured:
+
+  idle   the samplers run alone for --seconds
+  burst  the device streams --frames 'T' frames back to back
+
+For each window the X sampler period (min/max, jitter = max - min) comes
+from the 'B' command; the burst window also reports the link throughput
+seen by the host, and the idle line the time from reset to the first
+OLED frame.
+
+With the stick centred the sampling governor drops the samplers to their
+idle rate after half a second, so hold it off-centre (or keep moving it)
+during the idle window to measure the full rate.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+HDR, FTR = 0xD0, 0xDF
+TX_BURST_LEN = 16       # CMD_TX_BURST_LEN in main/cmd.h
+
+
+class Link:
+    def __init__(self, port):
+        self.ser = serial.Serial(port, 115200, timeout=1)
+        self.buf = bytearray()
+
+    def send(self, cmd, payload=b""):
+        self.ser.write(bytes([HDR, ord(cmd), len(payload)]) + payload + bytes([FTR]))
+
+    def frame(self):
+        """Next D0 frame as (cmd, payload); other packets are skipped."""
+        while True:
+            i = self.buf.find(HDR)
+            if i < 0:
+                self.buf.clear()
+            elif i > 0:
+                del self.buf[:i]
+            if len(self.buf) >= 3 and len(self.buf) >= 4 + self.buf[2]:
+                n = self.buf[2]
+                if self.buf[3 + n] == FTR:
+                    cmd, payload = self.buf[1], bytes(self.buf[3:3 + n])
+                    del self.buf[:4 + n]
+                    return chr(cmd), payload
+                del self.buf[:1]
+                continue
+            chunk = self.ser.read(max(1, self.ser.in_waiting))
+            if not chunk:
+                raise TimeoutError("no reply from device")
+            self.buf += chunk
+
+    def expect(self, cmd):
+        while True:
+            c, payload = self.frame()
+            if c == cmd:
+                return payload
+
+
+def bench_stats(link):
+    link.send("B")
+    samples, frames, pmin, pmax, now, boot_frame = struct.unpack(">6I", link.expect("B"))
+    return samples, pmin, pmax, boot_frame
+
+
+def report(label, window, pmin, pmax, extra=""):
+    if pmin == 0xFFFFFFFF:
+        print("build=%s window=%s no samples (is ENABLE on?)" % (label, window))
+        return
+    print("build=%s window=%s period_min_us=%d period_max_us=%d jitter_us=%d%s"
+          % (label, window, pmin, pmax, pmax - pmin, extra))
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("port")
+    ap.add_argument("--label", default="build")
+    ap.add_argument("--seconds", type=float, default=5.0)
+    ap.add_argument("--frames", type=int, default=4000)
+    args = ap.parse_args()
+
+    link = Link(args.port)
+    bench_stats(link)                       # open the idle window
+    time.sleep(args.seconds)
+    _, pmin, pmax, boot_frame = bench_stats(link)   # closes idle, opens burst
+    report(args.label, "idle", pmin, pmax, " boot_frame_us=%d" % boot_frame)
+
+    frames = min(args.frames, 0xFFFF)
+    t0 = time.monotonic()
+    link.send("T", struct.pack(">H", frames))
+    for _ in range(frames):
+        link.expect("T")
+    dt = time.monotonic() - t0
+    rx = frames * (4 + TX_BURST_LEN)
+    _, pmin, pmax, _ = bench_stats(link)
+    report(args.label, "burst", pmin, pmax,
+           " tx_frames=%d tx_kBps=%.1f" % (frames, rx / dt / 1000))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())